@@ -1,33 +1,41 @@
 #include <SPI.h>
 #include <RF24.h>
 
-#include "joypad.h"       // Inclure la bibliothèque joystick
+#include <ClubElectronique.h> // Inclure la bibliothèque commune du club
+#include <joypad.h>           // Inclure la bibliothèque joystick
+#include <trameCanaux.h>      // Inclure la trame proportionnelle multi-canaux
 
 #define CE_PIN   9
 #define CSN_PIN 10
 
+// **Période d'émission des trames (ms)**
+// A 2Mbps une trame de 13 octets occupe l'air à peu près autant qu'une trame de 4 octets à 1Mbps
+// toutes les 16ms : la cadence passe d'environ 60 à 83 trames par seconde pour le même temps d'antenne.
+#define PERIODE_TRAME 12
+
+// **Vitesse de variation des gaz avec les boutons A (plus) et C (moins), en pas de canal par trame**
+#define PAS_GAZ 8
+
 
 RF24 radio(CE_PIN, CSN_PIN);
 joypad manette;
 
-// **Structure pour contenir le message radio**
-typedef struct 
-{
-  int servoA;
-  int servoB;
-} radiomsg;
-
-radiomsg msg;
+// **Trame radio et valeurs des canaux**
+trameCanaux trame;
+uint16_t canaux[NB_CANAUX];
+uint8_t seq = 0;
 
 uint8_t address[][6] = { "1NODE", "2NODE" };
 uint8_t boutons;
 uint8_t radioPowerLevel = RF24_PA_LOW;
 
+// **Instant de la prochaine trame (ms)**
+unsigned long prochaineTrame = 0;
+
 void setup()
 {
-  delay(150);
+  // Pas d'attente du port série : sans hôte USB, `while (!Serial)` bloquerait la télécommande
   Serial.begin(115200);
-  while (!Serial) {} // some boards need to wait to ensure access to serial over USB  
   if (!radio.begin())
   {
     Serial.println(F("radio hardware is not responding!!"));
@@ -39,9 +47,12 @@ void setup()
   // each other.
   radio.setPALevel(RF24_PA_LOW);  // RF24_PA_MAX is default.
 
+  // 2Mbps pour raccourcir le temps d'antenne de chaque trame (à régler à l'identique sur l'avion)
+  radio.setDataRate(RF24_2MBPS);
+
   // save on transmission time by setting the radio to only transmit the
-  // number of bytes we need to transmit a float
-  radio.setPayloadSize(sizeof(msg));  // float datatype occupies 4 bytes
+  // number of bytes we need to transmit
+  radio.setPayloadSize(sizeof(trame));
 
   // set the TX address of the RX node into the TX pipe
   radio.openWritingPipe(address[0]);  // always uses pipe 0
@@ -51,40 +62,50 @@ void setup()
 
   radio.stopListening();               // Démarrer l'écoute radio
 
+  // Neutre du manche et de tous les canaux, gaz coupés
+  manette.lightCalibration();
+  for (uint8_t i = 0; i < NB_CANAUX; ++i)
+  {
+    canaux[i] = CANAL_CENTRE;
+  }
+  canaux[CANAL_GAZ] = CANAL_MIN;
+
+  prochaineTrame = millis();
   // Serial.println(F("Setup finish"));
 }
 
 void loop()
 {    
+  int8_t x = 0;
+  int8_t y = 0;
 
+  // Gouvernes proportionnelles au manche
+  manette.getAxis(x, y);
+  canaux[CANAL_PROFONDEUR] = pourcentageVersCanal(y);
+  canaux[CANAL_DIRECTION]  = pourcentageVersCanal(x);
+
+  // Gaz : A augmente, C diminue, E coupe
   boutons = manette.getButton();
-  // Altitude haut A
-  if (boutons & 0b00000001)
+  if (boutons & maskBoutonA)
+  {
+    canaux[CANAL_GAZ] = canaux[CANAL_GAZ] + PAS_GAZ > CANAL_MAX ? CANAL_MAX : canaux[CANAL_GAZ] + PAS_GAZ;
+  }
+  if (boutons & maskBoutonC)
   {
-      msg.servoA = 0;
-  } else if (boutons & 0b00000100)  // Altitude haut C
-    {
-        msg.servoA = 180;
-    } else 
-      {
-        msg.servoA = 90;  // retour normal
-      }
-
-  if (boutons & 0b00000010)   // Direction droite B
+    canaux[CANAL_GAZ] = canaux[CANAL_GAZ] < CANAL_MIN + PAS_GAZ ? CANAL_MIN : canaux[CANAL_GAZ] - PAS_GAZ;
+  }
+  if (boutons & maskBoutonE)
   {
-      msg.servoB = 00;
-  } else if (boutons & 0b00001000) // Direction gauche D
-    {
-        msg.servoB = 180;
-    } else 
-      {
-        msg.servoB = 90;
-      }
- 
-  if (!radio.write(&msg, sizeof(msg)))
+    canaux[CANAL_GAZ] = CANAL_MIN;
+  }
+
+  encoderTrame(trame, canaux, seq++);
+  if (!radio.write(&trame, sizeof(trame)))
   {
     Serial.println(F("msg not send"));
   }
-  delay(16);
-}
 
+  // Cadence fixe des trames
+  prochaineTrame += PERIODE_TRAME;
+  while ((long)(prochaineTrame - millis()) > 0) {}
+}
@@ -5,14 +5,40 @@
 // include the Servo library
 #include <Servo.h>
 
+#include <ClubElectronique.h>
+#include <trameCanaux.h>
+
+#include "servoRampe.h"
+#include <mixeur.h>
+
+//#define AVION_DEBUG // Afficher une fois par seconde le nombre de trames reçues
+
 // **Définition des broches utilisées**
 #define CE_PIN 7
 #define CSN_PIN 8
 
-Servo servoDir;
-Servo servoAlt;
+// **Cadence de déplacement des servos**
+#define PERIODE_SERVO 5    // ms entre deux pas des servos
+#define PAS_SERVO     40   // µs d'impulsion par pas, soit un débattement complet en environ 250ms
+
+// **Période d'affichage du journal (ms)**
+#define PERIODE_JOURNAL 1000
+
+// **Délai sans trame valide avant de centrer les gouvernes et couper les gaz (ms)**
+#define DELAI_FAILSAFE 500
+
+// **Plage d'impulsion du contrôleur moteur (µs)**
+#define GAZ_MIN 1000
+#define GAZ_MAX 2000
 
-int old_A, old_B;
+servoRampe servoDir(PAS_SERVO);
+servoRampe servoAlt(PAS_SERVO);
+servoRampe servoGaz(GAZ_MAX - GAZ_MIN); // Pas de rampe sur les gaz : la coupure doit être immédiate
+servoRampe servoAil(PAS_SERVO);
+
+// **Mixage des canaux vers les sorties servo**
+mixeur mix;
+uint16_t sorties[NB_SORTIES];
 
 // **Objet pour la communication radio**
 RF24 radio(CE_PIN, CSN_PIN); // instantiate an object for the nRF24L01 transceiver
@@ -23,29 +49,45 @@ uint8_t address[][6] = { "1NODE", "2NODE" };
 // **Niveau de puissance de la radio**
 uint8_t radioPowerLevel = RF24_PA_LOW;
 
-// **Structure pour contenir le message radio**
-typedef struct 
-{
-  int servoA;
-  int servoB;
-} radiomsg;
+// **Trame radio et valeurs des canaux**
+trameCanaux trame;
+uint16_t canaux[NB_CANAUX];
+
+// **Instant de la dernière trame valide et état du failsafe**
+unsigned long derniereTrame = 0;
+bool failsafeActif = true;
 
-radiomsg msg;
+// **Echéances des tâches de la boucle principale**
+unsigned long prochainPas = 0;
+unsigned long prochainJournal = 0;
+
+// **Compteurs pour le journal : trames lues, remplacées par une plus récente avant d'être appliquées,
+// perdues (trous dans les numéros de séquence) et invalides (CRC faux)**
+uint16_t nbTrames = 0;
+uint16_t nbTramesPerimees = 0;
+uint16_t nbTramesPerdues = 0;
+uint16_t nbTramesInvalides = 0;
+uint8_t  dernierSeq = 0;
 
 void setup()
 {
-  delay(3000);
   Serial.begin(115200); // Initialiser la communication série pour le débogage
-  servoDir.attach(2);   // attaches the servo on pin 2 to the servo direction of airplane // yaw
-  servoAlt.attach(3);   // attaches the servo on pin 2 to the servo direction of airplane // pitch
+  servoDir.attacher(2, 90);   // attaches the servo on pin 2 to the servo direction of airplane // yaw
+  servoAlt.attacher(3, 90);   // attaches the servo on pin 2 to the servo direction of airplane // pitch
   // roll pour roulie (tonneaux autour de l'axe central)
+  servoGaz.attacher(4, 0);    // contrôleur moteur sur la broche 4
+  servoAil.attacher(5, 90);   // ailerons sur la broche 5
+
+  // Configuration du mixage, calculée une fois pour toutes ici.
+  // Pour une aile volante : mix.configurerElevons(30); pour un empennage en V : mix.configurerVTail();
+  mix.configurerClassique();
+  mix.setExpo(CANAL_PROFONDEUR, 30);
+  mix.setExpo(CANAL_DIRECTION, 30);
+  mix.setExpo(CANAL_AILERONS, 30);
+  mix.setTrim(SORTIE_PROFONDEUR, 0);
+  mix.setFinsDeCourse(SORTIE_PROFONDEUR, -COURSE, COURSE);
 
-  // reset the servo position
-  servoAlt.write(90);
-  servoDir.write(90);
-  old_A = 90;
-  old_B = 90;
-  delay(150);
+  appliquerFailsafe();
 
    // Configurer la radio
   if (!radio.begin())
@@ -58,9 +100,12 @@ void setup()
   // each other.
   radio.setPALevel(radioPowerLevel);  // RF24_PA_MAX is default.
 
+  // Même débit que la télécommande
+  radio.setDataRate(RF24_2MBPS);
+
   // save on transmission time by setting the radio to only transmit the
-  // number of bytes we need to transmit a float
-  radio.setPayloadSize(sizeof(msg));  // float datatype occupies 
+  // number of bytes we need to transmit
+  radio.setPayloadSize(sizeof(trame));
 
   // set the TX address of the RX node into the TX pipe
   radio.openWritingPipe(address[1]);  // always uses pipe 0
@@ -75,30 +120,126 @@ void setup()
 
 void loop()
 {  
-  uint8_t pipe;
-  //Serial.println("A");
-  if (radio.available(&pipe)) // Vérifier si un message est disponible
+  unsigned long maintenant = millis();
+
+  // Appliquer immédiatement la trame valide la plus récente
+  if (recevoir())
+  {
+    derniereTrame = maintenant;
+    failsafeActif = false;
+    appliquerCanaux();
+  }
+  else if (!failsafeActif && maintenant - derniereTrame > DELAI_FAILSAFE)
+  {
+    appliquerFailsafe();
+  }
+
+  // Avancer les servos vers leur consigne à cadence fixe
+  if ((long)(maintenant - prochainPas) >= 0)
+  {
+    prochainPas = maintenant + PERIODE_SERVO;
+    servoAlt.pas();
+    servoDir.pas();
+    servoGaz.pas();
+    servoAil.pas();
+  }
+
+#ifdef AVION_DEBUG
+  // Journal hors du chemin critique, une fois par seconde
+  if ((long)(maintenant - prochainJournal) >= 0)
+  {
+    prochainJournal = maintenant + PERIODE_JOURNAL;
+    journal();
+  }
+#endif
+}
+
+/**
+ * @brief Vider la FIFO de la radio en ne gardant que la trame valide la plus récente
+ * @return true si au moins une trame valide a été lue
+ */
+bool recevoir()
+{
+  uint8_t valides = 0;
+
+  while (radio.available())
   {
-    Serial.println(F("Message reçu !"));
-    Serial.println(msg.servoA);
-    Serial.println(msg.servoB);
-    //Serial.println("B");
-    uint8_t bytes = radio.getPayloadSize(); // Obtenir
-    radio.read(&msg, bytes);                 // Lire le message radio
-    // set the servo position
-    servoAlt.write(msg.servoA);
-    servoDir.write(msg.servoB);
-    if (msg.servoA != old_A || msg.servoB != old_B){
-      delay(150);
-      old_A = msg.servoA;
-      old_B = msg.servoB;
+    radio.read(&trame, sizeof(trame));
+    ++nbTrames;
+
+    if (!decoderTrame(trame, canaux))
+    {
+      ++nbTramesInvalides;
+      continue;
     }
 
+    nbTramesPerdues += (uint8_t)(trame.seq - dernierSeq - 1);
+    dernierSeq = trame.seq;
+    ++valides;
   }
-  else
+
+  if (valides)
+  {
+    nbTramesPerimees += valides - 1;
+  }
+  return valides;
+}
+
+/**
+ * @brief Convertir une valeur de canal en largeur d'impulsion
+ */
+uint16_t canalVersMicrosecondes(uint16_t valeur, uint16_t impulsionMin, uint16_t impulsionMax)
+{
+  return map(valeur, CANAL_MIN, CANAL_MAX, impulsionMin, impulsionMax);
+}
+
+/**
+ * @brief Mixer les canaux reçus et donner aux servos leurs consignes
+ */
+void appliquerCanaux()
+{
+  mix.calculer(canaux, sorties);
+
+  servoAlt.consigneMicrosecondes(canalVersMicrosecondes(sorties[SORTIE_PROFONDEUR], MIN_PULSE_WIDTH, MAX_PULSE_WIDTH));
+  servoDir.consigneMicrosecondes(canalVersMicrosecondes(sorties[SORTIE_DIRECTION],  MIN_PULSE_WIDTH, MAX_PULSE_WIDTH));
+  servoGaz.consigneMicrosecondes(canalVersMicrosecondes(sorties[SORTIE_GAZ], GAZ_MIN, GAZ_MAX));
+  servoAil.consigneMicrosecondes(canalVersMicrosecondes(sorties[SORTIE_AILERONS],   MIN_PULSE_WIDTH, MAX_PULSE_WIDTH));
+}
+
+/**
+ * @brief Centrer les gouvernes et couper les gaz après une perte de liaison
+ *
+ * Les canaux passent par le mixeur comme une trame normale : les trims restent appliqués.
+ */
+void appliquerFailsafe()
+{
+  for (uint8_t i = 0; i < NB_CANAUX; ++i)
   {
-    Serial.println("Radio not available");
+    canaux[i] = CANAL_CENTRE;
   }
-  delay(16);
+  canaux[CANAL_GAZ] = CANAL_MIN;
+
+  appliquerCanaux();
+  failsafeActif = true;
 }
 
+/**
+ * @brief Afficher et remettre à zéro les compteurs de trames
+ */
+void journal()
+{
+  Serial.print(F("Trames "));
+  Serial.print(nbTrames);
+  Serial.print(F(" perimees "));
+  Serial.print(nbTramesPerimees);
+  Serial.print(F(" perdues "));
+  Serial.print(nbTramesPerdues);
+  Serial.print(F(" invalides "));
+  Serial.print(nbTramesInvalides);
+  Serial.println(failsafeActif ? F(" FAILSAFE") : F(""));
+
+  nbTrames = 0;
+  nbTramesPerimees = 0;
+  nbTramesPerdues = 0;
+  nbTramesInvalides = 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file servoRampe.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `servoRampe` qui amène un servo vers sa consigne à vitesse limitée.
+ *
+ * La consigne peut changer à chaque trame radio sans bloquer le programme : à chaque appel de `pas()`,
+ * la position du servo avance d'au plus `pasMax` microsecondes d'impulsion vers la consigne.
+ */
+
+#pragma once
+#ifndef SERVORAMPE_h
+#define SERVORAMPE_h
+
+#include <Servo.h>
+
+class servoRampe
+{
+public:
+    inline servoRampe(uint16_t pasMax) : m_position(DEFAULT_PULSE_WIDTH), m_cible(DEFAULT_PULSE_WIDTH), m_pasMax(pasMax) {}
+
+    inline void attacher(uint8_t pin, int angle);
+    inline void consigne(int angle);
+    inline void consigneMicrosecondes(uint16_t impulsion);
+    inline void pas();
+
+    inline bool enPosition() const { return m_position == m_cible; }
+
+    static inline uint16_t angleVersMicrosecondes(int angle);
+
+private:
+    Servo    m_servo;     ///< Servo piloté
+    uint16_t m_position;  ///< Largeur d'impulsion actuellement envoyée au servo (µs)
+    uint16_t m_cible;     ///< Largeur d'impulsion demandée (µs)
+    uint16_t m_pasMax;    ///< Variation maximale de la largeur d'impulsion par pas (µs)
+};
+
+
+
+/**
+ * @brief Attacher le servo à sa broche et le placer immédiatement à un angle
+ *
+ * @param pin   [In] Broche de commande du servo
+ * @param angle [In] Angle initial en degrés (0 à 180)
+ */
+inline void servoRampe::attacher(uint8_t pin, int angle)
+{
+    m_servo.attach(pin);
+    m_position = m_cible = angleVersMicrosecondes(angle);
+    m_servo.writeMicroseconds(m_position);
+}
+
+/**
+ * @brief Changer la consigne du servo
+ *
+ * @param angle [In] Angle demandé en degrés (0 à 180)
+ */
+inline void servoRampe::consigne(int angle) { m_cible = angleVersMicrosecondes(angle); }
+
+/**
+ * @brief Changer la consigne du servo en largeur d'impulsion
+ *
+ * @param impulsion [In] Largeur d'impulsion demandée en microsecondes
+ */
+inline void servoRampe::consigneMicrosecondes(uint16_t impulsion) { m_cible = constrain(impulsion, MIN_PULSE_WIDTH, MAX_PULSE_WIDTH); }
+
+/**
+ * @brief Avancer le servo d'un pas vers sa consigne
+ *
+ * Ne fait rien lorsque le servo est déjà à sa consigne.
+ */
+inline void servoRampe::pas()
+{
+    if (m_position == m_cible) return;
+
+    if (m_cible > m_position)
+    {
+        m_position = (m_cible - m_position > m_pasMax) ? m_position + m_pasMax : m_cible;
+    }
+    else
+    {
+        m_position = (m_position - m_cible > m_pasMax) ? m_position - m_pasMax : m_cible;
+    }
+
+    m_servo.writeMicroseconds(m_position);
+}
+
+/**
+ * @brief Convertir un angle en largeur d'impulsion, comme `Servo::write`
+ *
+ * @param angle [In] Angle en degrés, ramené entre 0 et 180
+ * @return Largeur d'impulsion en microsecondes
+ */
+inline uint16_t servoRampe::angleVersMicrosecondes(int angle)
+{
+    angle = constrain(angle, 0, 180);
+    return map(angle, 0, 180, MIN_PULSE_WIDTH, MAX_PULSE_WIDTH);
+}
+
+#endif
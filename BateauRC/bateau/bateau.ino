@@ -10,14 +10,25 @@
  */
 
 #define BATEAU_DEBUG
+//#define BATEAU_SAUT_FREQUENCE // Suivre le saut de fréquence de la télécommande (TELECOMMANDE_SAUT_FREQUENCE)
 
 #include <SPI.h>
 #include <RF24.h>
 
-#include "common.h"
-#include "radioMessage.h"
-#include "pontH.h"
-#include "reboot.h"
+#include <ClubElectronique.h>
+#include <radioMessage.h>
+#include <pontH.h>
+#include <reboot.h>
+#include <veille.h>
+#include <chronoDemarrage.h>
+#include <boiteNoire.h>
+#include <lisseurConsigne.h>
+#include <parametres.h>
+#include <sondeRadio.h>
+#include <sautFrequence.h>
+#include <executif.h>
+
+#include "superviseur.h"
 
 // **Définition des broches utilisées**
 #define moteurGauchePWM       6
@@ -28,9 +39,57 @@
 #define CE_PIN 7
 #define CSN_PIN 8
 
+// **Délai sans message radio avant de commencer à arrêter les moteurs (ms)**
+#define DELAI_FAILSAFE 100
+
+// **Durée de la décroissance des moteurs jusqu'à l'arrêt complet (ms)**
+#define DUREE_ARRET 300
+
+// **Arrêt des moteurs : frein actif (les deux entrées du pont à l'état haut) pendant DUREE_FREIN ms quand un
+// moteur revient à 0, puis roue libre. 0 pour toujours s'arrêter en roue libre. Avec FREIN_FAILSAFE, la fin
+// du failsafe freine aussi au lieu de laisser dériver le bateau.**
+#define DUREE_FREIN    150
+#define FREIN_FAILSAFE true
+
+// **Décroissance du courant entre deux impulsions PWM (motorBank.h). La broche de direction 4 n'étant pas
+// une sortie PWM, ce câblage n'accepte que la décroissance mixte. La décroissance lente tient mieux la
+// vitesse à faible régime : à choisir sur un bateau recâblé avec deux broches de direction PWM.**
+#define DECROISSANCE DECROISSANCE_MIXTE
+//#define DECROISSANCE DECROISSANCE_LENTE
+
+// **Lissage des consignes : période d'application aux moteurs, durée maximale d'une rampe, durée maximale
+// d'une rampe quand aucune trame ne manque et prolongation d'une rampe quand une trame manque (ms)**
+#define PERIODE_LISSAGE      10
+#define RAMPE_MAX            100
+#define RAMPE_SUIVIE         20  // RAMPE_MAX avec une télécommande à cadence fixe (TELECOMMANDE_CADENCE_FIXE)
+#define EXTRAPOLATION_MAX    0   // 50 avec une télécommande à cadence fixe (TELECOMMANDE_CADENCE_FIXE)
+
+// **Périodes des tâches cadencées par l'exécutif (µs) : moteurs à 1kHz, entretien à 10Hz. La radio est servie
+// à chaque tour, dès qu'une trame arrive ; la boîte noire écrit dans les tours où la radio n'a rien reçu, au
+// rythme de l'EEPROM (3,4ms par octet).**
+#define PERIODE_MOTEURS   1000
+#define PERIODE_ENTRETIEN 100000
+
+// **Graine de la séquence de saut de fréquence, la même sur le bateau et la télécommande**
+#define GRAINE_SAUT 0x4A42
+
+// **Délai sans message radio avant de passer en écoute économe (ms)**
+#define DELAI_VEILLE 2000
+
+// **Cycle d'écoute économe : la radio écoute FENETRE_ECOUTE ms toutes les PERIODE_VEILLE ms**
+// La fenêtre doit dépasser la période d'émission de la télécommande pour ne manquer aucune reprise.
+#define PERIODE_VEILLE 1000
+#define FENETRE_ECOUTE 150
+
 // **Variable pour stocker le timestamp**
 unsigned long time = 0;
 
+// **Dernière consigne reçue et état de l'arrêt des moteurs**
+int8_t derniereGauche = 0;
+int8_t dernierDroit   = 0;
+bool   moteursArretes = true;
+bool   liaisonPerdue  = false;
+
 // **Objet pour la communication radio**
 RF24    radio(CE_PIN, CSN_PIN); // instantiate an object for the nRF24L01 transceiver
 
@@ -40,6 +99,50 @@ radioMessage msg;
 // **Objet pour piloter les moteurs**
 pontH    pont(moteurGauchePWM, moteurGaucheDirection, moteurDroitPWM, moteurDroitDirection);
 
+// **Objet pour surveiller la boucle principale avec le watchdog**
+superviseur garde;
+
+// **Exécutif qui cadence les tâches de la boucle principale et mesure leur budget processeur**
+executif<4> taches;
+
+// **Une trame a été traitée pendant ce tour de boucle : la boîte noire attend un tour creux**
+bool trameTraitee = false;
+
+// **Objet pour endormir le bateau pendant l'écoute économe**
+veille sommeil;
+
+// **Objet pour mesurer le temps jusqu'à la première trame valide**
+chronoDemarrage chrono;
+
+// **Objet pour enregistrer les incidents de la liaison radio**
+boiteNoire boite;
+
+// **Objet pour lisser les consignes entre deux trames radio**
+lisseurConsigne lisseur(PERIODE_LISSAGE, RAMPE_MAX, RAMPE_SUIVIE, EXTRAPOLATION_MAX);
+
+// **Instant de la prochaine application de la consigne lissée**
+unsigned long prochainLissage = 0;
+
+// **Paramètres réglables depuis la télécommande, et changements à appliquer entre deux cycles**
+registreParametres parametres;
+bool parametresModifies = false;
+bool sauvegardeDemandee = false;
+
+// **Etat de la radio pendant l'écoute économe**
+bool radioEteinte = false;
+
+// **Radio passée à d'autres réglages par une mesure de la liaison (sondeRadio.h)**
+bool radioReglee = false;
+
+// **Trames reçues pendant les rafales de test de la liaison, renvoyées à la télécommande sur demande**
+compteurRafale rafale;
+
+#ifdef BATEAU_SAUT_FREQUENCE
+// **Séquence de saut de fréquence, et canal d'écoute de la radio**
+sautFrequence saut(GRAINE_SAUT);
+uint8_t canalEcoute = 0xFF;
+#endif
+
 
 // **Tableaux contenant les adresses radio pour l'émetteur et le récepteur**
 uint8_t address[][6] = { "1NODE", "2NODE" };
@@ -54,9 +157,8 @@ uint8_t radioPowerLevel = RF24_PA_LOW;
  */
 void setup()
 {
-  delay(1000);
+  // Pas d'attente du port série : sans hôte USB, `while (!Serial)` bloquerait le bateau
   Serial.begin(115200); // Initialiser la communication série pour le débogage
-  while (!Serial) {} // some boards need to wait to ensure access to serial over USB  
 
   debugln("coucou");
 
@@ -64,7 +166,7 @@ void setup()
   pont.stopMoteurs();
 
 
-  // Configurer la radio
+  // Configurer la radio en premier : elle écoute déjà pendant le reste de l'initialisation
   if (!radio.begin())
   {
     Serial.println(F("radio hardware is not responding!!"));
@@ -91,6 +193,31 @@ void setup()
   radio.startListening();               // Démarrer l'écoute radio
   debugln("coucou4");
 
+  // Charger la calibration des moteurs pendant que les premières trames arrivent
+  pont.chargerCalibration();
+  lireParametresMoteurs();
+  pont.setDureeFrein(DUREE_FREIN);
+  if (!pont.setDecroissance(DECROISSANCE))
+  {
+    debugln(F("Decroissance mixte : broche de direction sans PWM"));
+  }
+
+  // Démarrer la surveillance de la boucle principale
+  garde.demarrer();
+
+  // Cadencer les tâches, par ordre de priorité
+  taches.ajouter(tacheMoteurs, PERIODE_MOTEURS);
+  taches.ajouter(tacheRadio, A_LA_DEMANDE);
+  taches.ajouter(tacheBoite, A_LA_DEMANDE);
+  taches.ajouter(tacheEntretien, PERIODE_ENTRETIEN);
+  taches.demarrer();
+
+  // Retrouver la boîte noire et y noter ce démarrage
+  boite.demarrer();
+  boite.noter(EVT_DEMARRAGE, garde.cause(), true);
+#ifdef BATEAU_DEBUG
+  garde.rapport();
+#endif
 }
 
 /**
@@ -98,40 +225,427 @@ void setup()
  */
 void loop()
 {
-  //while(1);
+  // Dormir pendant la phase éteinte de l'écoute économe
+  if (ecouteEconome())
+  {
+    boite.vider();
+    sommeil.sieste();
+    taches.recaler(); // Les créneaux passés en veille ne sont pas des dépassements
+    garde.boucle();
+    return;
+  }
+
+  // Servir la radio et les tâches dont le créneau est échu
+  taches.tourner();
+
+  // Signaler un tour complet de la boucle au watchdog
+  garde.boucle();
+}
+
+/**
+ * @brief Tâche des moteurs, toutes les PERIODE_MOTEURS µs
+ *
+ * Les paramètres reçus sont appliqués d'un bloc avant la consigne lissée, puis le failsafe arrête
+ * progressivement les moteurs après DELAI_FAILSAFE ms d'inactivité radio. Les freins arrivés au bout de
+ * DUREE_FREIN ms sont relâchés.
+ */
+bool tacheMoteurs()
+{
+  appliquerParametres();
+  appliquerConsigne();
+  failsafe();
+  pont.relacherFreins();
+  return true;
+}
+
+/**
+ * @brief Tâche radio, à la demande : traiter la trame reçue
+ * @return false si aucune trame n'attendait
+ */
+bool tacheRadio()
+{
   uint8_t pipe;
-  
-  if (radio.available(&pipe)) // Vérifier si un message est disponible
-  {
-    uint8_t bytes = radio.getPayloadSize(); // Obtenir
-    radio.read(&msg, bytes);                 // Lire le message radio
-
-    if(messageIsValid(msg))// Vérifier la validité du message
-    {
-      // Mettre à jour le timestamp
-      time = millis();
-      debug((int)msg.gauche);
-      debug(", ");
-      debugln((int)msg.droit);
-      pont.vitesseMoteurs(msg.gauche, msg.droit); // Piloter les moteurs en fonction des vitesses reçues
-      controleBateau(msg.cmd);
-    }
-    else
-    {
-      messageInvalid(); // Signaler la réception d'un message invalide
-    }
+
+#ifdef BATEAU_SAUT_FREQUENCE
+  // Écouter sur le canal du créneau en cours
+  suivreSaut();
+#endif
+
+  trameTraitee = radio.available(&pipe);
+  if (!trameTraitee) return false; // Vérifier si un message est disponible
+
+  uint8_t bytes = radio.getPayloadSize(); // Obtenir
+  radio.read(&msg, bytes);                 // Lire le message radio
+
+  if (!messageIsValid(msg)) // Vérifier la validité du message
+  {
+    messageInvalid(); // Signaler la réception d'un message invalide
+    return true;
+  }
+
+  boite.trame(msg.seq);
+  if (liaisonPerdue)
+  {
+    unsigned long silence = (millis() - time) / 100;
+    boite.noter(EVT_REPRISE, silence > 255 ? 255 : silence);
+    liaisonPerdue = false;
+  }
+
+  // Mettre à jour le timestamp
+  time = millis();
+  chrono.trameValide();
+#ifdef BATEAU_SAUT_FREQUENCE
+  saut.recue(msg.seq, time); // Recaler l'horloge des créneaux
+#endif
+  if (msg.cmd & radioCmd::SONDE)
+  {
+    // Mesure de la liaison : l'écho part avant l'arrêt des moteurs et sa trace, qui fausseraient l'aller-retour ;
+    // moteurs arrêtés dès la première sonde, sans trace ensuite pour suivre le rythme des rafales
+    recevoirSonde(msg);
+    if (!moteursArretes) arreterMoteurs(false);
+    return true;
+  }
+
+  debug((int)msg.gauche);
+  debug(", ");
+  debugln((int)msg.droit);
+#ifdef BATEAU_SAUT_FREQUENCE
+  if (sautFrequence::estAnnonce(msg))
+  {
+    saut.appliquerAnnonce(msg); // Changement de la liste noire, la consigne des moteurs est maintenue
+  }
+  else
+#endif
+  if (msg.cmd & radioCmd::PARAM)
+  {
+    recevoirParametre(msg); // La consigne des moteurs est maintenue le temps de ce message
   }
   else
+  {
+    lisseur.recevoir(msg.gauche, msg.droit, msg.seq, time); // Les moteurs rejoignent la consigne reçue par une rampe
+    moteursArretes = false;
+  }
+  controleBateau(msg.cmd);
+  return true;
+}
+
+/**
+ * @brief Tâche de la boîte noire, à la demande : écrire au plus un octet en EEPROM, seulement dans un tour
+ * de boucle où la radio n'avait pas de trame à traiter
+ * @return false si rien n'a été écrit
+ */
+bool tacheBoite()
+{
+  return !trameTraitee && boite.vider();
+}
+
+/**
+ * @brief Tâche d'entretien, toutes les PERIODE_ENTRETIEN µs
+ */
+bool tacheEntretien()
+{
+  // Revenir aux réglages radio de démarrage si la mesure de la liaison s'est interrompue
+  retablirRadio();
+
+  // Regrouper les trames perdues et invalides dans la boîte noire
+  boite.tic(millis(), garde.courant().periodeMax);
+
+  if (millis() - time > DELAI_FAILSAFE)
   {
     debugln("Radio not available");
   }
 
+  // Traiter les commandes reçues sur le port série
+  if (Serial.available())
+  {
+    commandeSerie(toupper(Serial.read()));
+  }
+  return true;
+}
 
-  // Arréter les moteurs après 100ms d'inactivité radio
-  if(millis() > time+100)
+/**
+ * @brief Fonction pour afficher le nom d'une tâche dans le budget processeur
+ */
+void afficherTache(Print & sortie, uint8_t tache)
+{
+  switch (tache)
+  {
+  case 0:  sortie.print(F("moteurs")); break;
+  case 1:  sortie.print(F("radio"));   break;
+  case 2:  sortie.print(F("boite"));   break;
+  case 3:  sortie.print(F("entret.")); break;
+  default: sortie.print(F("?"));       break;
+  }
+}
+
+/**
+ * @brief Fonction pour appliquer la consigne lissée aux moteurs toutes les PERIODE_LISSAGE ms
+ *
+ * Le failsafe pilote seul les moteurs dès que la liaison est perdue, en partant de la dernière consigne
+ * appliquée ici.
+ */
+void appliquerConsigne()
+{
+  if (moteursArretes || liaisonPerdue || (long)(millis() - prochainLissage) < 0) return;
+  prochainLissage = millis() + PERIODE_LISSAGE;
+
+  lisseur.avancer(millis());
+  derniereGauche = lisseur.gauche();
+  dernierDroit   = lisseur.droit();
+  pont.vitesseMoteurs(derniereGauche, dernierDroit);
+}
+
+/**
+ * @brief Fonction pour recopier les réglages des moteurs dans le registre des paramètres
+ */
+void lireParametresMoteurs()
+{
+  parametres.ecrire(PARAM_REGIME_GAUCHE_ARRIERE, pont.regimeMinimum(0, false));
+  parametres.ecrire(PARAM_REGIME_GAUCHE_AVANT,   pont.regimeMinimum(0, true));
+  parametres.ecrire(PARAM_REGIME_DROIT_ARRIERE,  pont.regimeMinimum(1, false));
+  parametres.ecrire(PARAM_REGIME_DROIT_AVANT,    pont.regimeMinimum(1, true));
+  parametres.ecrire(PARAM_OVERBOOST_GAUCHE,      pont.overBoostDelay(0));
+  parametres.ecrire(PARAM_OVERBOOST_DROIT,       pont.overBoostDelay(1));
+}
+
+/**
+ * @brief Fonction pour prendre en compte un message de paramètre
+ *
+ * Le paramètre est vérifié et rangé dans le registre ; il ne sera appliqué aux moteurs que par
+ * `appliquerParametres`, entre deux cycles de pilotage.
+ *
+ * @param message Le message reçu, `gauche` portant l'identifiant et `droit` la valeur
+ */
+void recevoirParametre(radioMessage const & message)
+{
+  uint8_t id = message.gauche;
+  if (registreParametres::existe(id) && registreParametres::description(id).bateau && parametres.ecrire(id, message.droit))
+  {
+    parametresModifies = true;
+  }
+  if (message.cmd & radioCmd::PARAM_SAUVER)
+  {
+    sauvegardeDemandee = true;
+  }
+}
+
+/**
+ * @brief Fonction pour appliquer les paramètres reçus aux moteurs, tous ensemble
+ *
+ * La sauvegarde demandée par la télécommande range les réglages des moteurs avec leur calibration.
+ */
+void appliquerParametres()
+{
+  if (parametresModifies)
+  {
+    pont.setRegimeMinimum(0, false, parametres.lire(PARAM_REGIME_GAUCHE_ARRIERE));
+    pont.setRegimeMinimum(0, true,  parametres.lire(PARAM_REGIME_GAUCHE_AVANT));
+    pont.setRegimeMinimum(1, false, parametres.lire(PARAM_REGIME_DROIT_ARRIERE));
+    pont.setRegimeMinimum(1, true,  parametres.lire(PARAM_REGIME_DROIT_AVANT));
+    pont.setOverBoostDelay(0, parametres.lire(PARAM_OVERBOOST_GAUCHE));
+    pont.setOverBoostDelay(1, parametres.lire(PARAM_OVERBOOST_DROIT));
+    parametresModifies = false;
+  }
+
+  if (sauvegardeDemandee)
+  {
+    pont.sauverCalibration();
+    sauvegardeDemandee = false;
+  }
+}
+
+/**
+ * @brief Fonction pour arrêter les moteurs en cas de perte de la liaison radio
+ *
+ * Après DELAI_FAILSAFE ms sans message valide, la dernière consigne est réduite linéairement
+ * jusqu'à 0 en DUREE_ARRET ms, puis les moteurs sont arrêtés une seule fois.
+ */
+void failsafe()
+{
+  unsigned long silence = millis() - time;
+
+  if (moteursArretes || silence <= DELAI_FAILSAFE) return;
+
+  if (!liaisonPerdue)
+  {
+    boite.noter(EVT_FAILSAFE, 0, true);
+    liaisonPerdue = true;
+  }
+
+  unsigned long decroissance = silence - DELAI_FAILSAFE;
+  if (decroissance >= DUREE_ARRET)
+  {
+    arreterMoteurs(FREIN_FAILSAFE);
+    return;
+  }
+
+  // La trame qui rétablit la liaison repart de la consigne en cours de décroissance
+  int16_t reste = DUREE_ARRET - decroissance;
+  int8_t gauche = derniereGauche * reste / DUREE_ARRET;
+  int8_t droit  = dernierDroit   * reste / DUREE_ARRET;
+  pont.vitesseMoteurs(gauche, droit);
+  lisseur.imposer(gauche, droit);
+}
+
+/**
+ * @brief Fonction pour arrêter les moteurs tout de suite, jusqu'à la prochaine consigne reçue
+ * @param freiner Freiner pendant DUREE_FREIN ms avant la roue libre
+ */
+void arreterMoteurs(bool freiner)
+{
+  if (freiner)
+  {
+    pont.freinerMoteurs(DUREE_FREIN);
+  }
+  else
   {
     pont.stopMoteurs();
   }
+  lisseur.imposer(0, 0);
+  derniereGauche = 0;
+  dernierDroit   = 0;
+  moteursArretes = true;
+}
+
+/**
+ * @brief Fonction pour traiter une trame de mesure de la liaison
+ *
+ * Une sonde est renvoyée telle quelle à la télécommande, qui en mesure le temps d'aller-retour. Un
+ * changement de réglages est appliqué après son acquittement, déjà émis par la radio. Les trames de
+ * rafale sont seulement comptées, et une demande de bilan reçoit les compteurs en réponse.
+ *
+ * @param message La trame reçue
+ */
+void recevoirSonde(radioMessage const & message)
+{
+  radioMessage reponse = message;
+  switch (typeTrameSonde(message))
+  {
+  case SONDE_REGLAGE:
+    radio.setPALevel(message.gauche);
+    radio.setDataRate((rf24_datarate_e)message.droit);
+    radioReglee = (uint8_t)message.gauche != radioPowerLevel || message.droit != DEBIT_DEMARRAGE;
+    rafale.remettreAZero();
+    return;
+  case SONDE_RAFALE:
+    rafale.recue();
+    return;
+  case SONDE_BILAN:
+    rafale.preparerBilan(reponse); // Compteurs conservés : la demande peut être répétée
+    break;
+  case SONDE_ECHO:
+    break;
+  default:
+    return;
+  }
+
+  radio.stopListening();
+  radio.write(&reponse, sizeof(reponse));
+  radio.startListening();
+}
+
+/**
+ * @brief Fonction pour revenir aux réglages radio de démarrage après DELAI_REGLAGE_SONDE ms sans trame
+ *
+ * La télécommande et le bateau se retrouvent ainsi même si le dernier changement de réglages d'une
+ * mesure de la liaison n'a pas été acquitté.
+ */
+void retablirRadio()
+{
+  if (!radioReglee || millis() - time < DELAI_REGLAGE_SONDE) return;
+
+  radio.setPALevel(radioPowerLevel);
+  radio.setDataRate((rf24_datarate_e)DEBIT_DEMARRAGE);
+  radioReglee = false;
+}
+
+#ifdef BATEAU_SAUT_FREQUENCE
+/**
+ * @brief Fonction pour passer la radio sur le canal d'écoute du créneau en cours
+ *
+ * Le changement de canal ne coûte qu'une écriture de registre, et seulement quand le canal change.
+ */
+void suivreSaut()
+{
+  uint8_t canal = saut.canalEcoute(millis());
+  if (canal != canalEcoute)
+  {
+    radio.setChannel(canal);
+    canalEcoute = canal;
+  }
+}
+#endif
+
+/**
+ * @brief Fonction pour gérer l'écoute économe après une longue perte de liaison
+ *
+ * Après DELAI_VEILLE ms sans message valide, la radio n'écoute plus que FENETRE_ECOUTE ms toutes les
+ * PERIODE_VEILLE ms et reste éteinte le reste du temps. Le premier message valide reçu pendant une
+ * fenêtre d'écoute remet le bateau en écoute permanente.
+ *
+ * @return true si la radio est éteinte et que le bateau peut dormir, false sinon
+ */
+bool ecouteEconome()
+{
+  unsigned long silence = millis() - time;
+  bool eteindre = silence >= DELAI_VEILLE && (silence - DELAI_VEILLE) % PERIODE_VEILLE >= FENETRE_ECOUTE;
+
+  if (eteindre && !radioEteinte)
+  {
+    radio.powerDown();
+    radioEteinte = true;
+  }
+  else if (!eteindre && radioEteinte)
+  {
+    radio.powerUp();
+    radio.startListening();
+    radioEteinte = false;
+  }
+
+  return radioEteinte;
+}
+
+/**
+ * @brief Fonction pour traiter une commande reçue sur le port série
+ * @param commande Le caractère reçu (en majuscule)
+ */
+void commandeSerie(char commande)
+{
+  switch (commande)
+  {
+  case 'C': // Calibration des moteurs, trop longue pour le watchdog
+    garde.suspendre();
+    pont.calibration();
+    pont.sauverCalibration();
+    lireParametresMoteurs();
+    garde.reprendre();
+    taches.remettreAZero(); // La calibration fausserait le budget processeur
+    break;
+  case 'S': // Santé de la boucle principale et durée des démarrages
+    garde.rapport();
+    chrono.rapport();
+    break;
+  case 'E': // Rapport cyclique et autonomie depuis la dernière commande 'E'
+    sommeil.rapport();
+    sommeil.demarrerMesure();
+    break;
+  case 'B': // Contenu de la boîte noire, à décoder avec decodeur_boite_noire
+    boite.dump();
+    break;
+  case 'P': // Paramètres réglables depuis la télécommande
+    parametres.afficher(Serial);
+    break;
+  case 'U': // Budget processeur des tâches depuis la dernière commande 'U'
+    taches.rapport(Serial, afficherTache);
+    taches.remettreAZero();
+    break;
+#ifdef BATEAU_SAUT_FREQUENCE
+  case 'F': // Séquence de saut de fréquence et liste noire reçue de la télécommande
+    Serial.println(saut.synchronise(millis()) ? F("Synchronise") : F("Canal de recherche"));
+    saut.afficher(Serial);
+    break;
+#endif
+  }
 }
 
 /**
@@ -141,7 +655,11 @@ void loop()
 void controleBateau(char cmd)
 {
   // Gérer la commande de redémarrage
-  if(cmd & radioCmd::RESET) reboot();
+  if(cmd & radioCmd::RESET)
+  {
+    garde.preparerReboot();
+    reboot();
+  }
 
   // Gérer la commande de changement de puissance radio
   if(cmd & 0b111)
@@ -162,6 +680,8 @@ void controleBateau(char cmd)
  */
 void messageInvalid()
 {
+  boite.trameInvalide();
+  rafale.invalide();
   debugln("Reception d'un message invalid");
   debug(*reinterpret_cast<uint32_t*>(&msg), HEX);
   debugln();
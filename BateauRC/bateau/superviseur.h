@@ -0,0 +1,238 @@
+/**
+ * @file superviseur.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `superviseur` qui surveille la santé de la boucle principale à l'aide du watchdog.
+ *
+ * Le watchdog matériel n'est nourri que lorsque la boucle progresse : si `loop()` se bloque, le système
+ * redémarre. Les périodes minimale, moyenne et maximale de la boucle ainsi que la cause du dernier
+ * redémarrage sont rangées dans une section `.noinit` qui survit au redémarrage.
+ *
+ * Optiboot (bootloader des Uno et des Nano récents) remet MCUSR à zéro avant de lancer le croquis : la cause
+ * du reset n'est alors connue que par le registre r2, où Optiboot 5 et suivants la recopient. Un Optiboot
+ * plus ancien la perd, et tout redémarrage passe pour un reset externe ; reflasher le bootloader (MiniCore,
+ * ou l'Optiboot récent de l'IDE) ou programmer le croquis sans bootloader, par ISP.
+ */
+
+#pragma once
+#ifndef SUPERVISEUR_h
+#define SUPERVISEUR_h
+
+#include <avr/wdt.h>
+
+#include <common.h>
+
+/**
+ * @brief Cause du dernier redémarrage
+ */
+typedef enum : uint8_t
+{
+    RESET_ALIMENTATION = 0, ///< Mise sous tension
+    RESET_EXTERNE,          ///< Bouton reset ou programmation
+    RESET_BROWNOUT,         ///< Chute de tension d'alimentation
+    RESET_WATCHDOG,         ///< Boucle principale bloquée
+    RESET_DEMANDE           ///< Redémarrage demandé par `reboot()`
+} causeReset;
+
+/**
+ * @brief Statistiques de la boucle principale, conservées d'un redémarrage à l'autre
+ */
+typedef struct
+{
+    uint16_t magic;         ///< Marqueur de validité du contenu de la section `.noinit`
+    uint16_t periodeMin;    ///< Période minimale de la boucle en microsecondes
+    uint16_t periodeMax;    ///< Période maximale de la boucle en microsecondes
+    uint32_t periodeSomme;  ///< Somme des périodes en microsecondes (pour la moyenne)
+    uint16_t nbPeriodes;    ///< Nombre de périodes cumulées dans `periodeSomme`
+    uint8_t  nbWatchdog;    ///< Nombre de redémarrages par le watchdog depuis la mise sous tension
+    bool     rebootDemande; ///< Positionné juste avant un redémarrage volontaire
+} santeBoucle;
+
+/**
+ * @brief Copie du registre MCUSR (ou de r2 passé par Optiboot) faite avant `main()`, le registre étant remis
+ * à zéro juste après
+ */
+uint8_t     g_mcusr       __attribute__((section(".noinit")));
+santeBoucle g_santeBoucle __attribute__((section(".noinit")));
+
+/**
+ * @brief Sauvegarde MCUSR et coupe le watchdog au tout début du démarrage
+ *
+ * Après un redémarrage par le watchdog, celui-ci reste actif avec son délai le plus court : il faut
+ * le couper avant que l'initialisation de l'Arduino ne dépasse ce délai. Sans bootloader, MCUSR porte
+ * toujours au moins un drapeau après un reset ; s'il est nul, Optiboot l'a vidé et la cause est dans r2,
+ * que le code de démarrage n'a pas encore touché.
+ */
+void sauverMCUSR() __attribute__((naked, used, section(".init3")));
+void sauverMCUSR()
+{
+    uint8_t r2;
+    __asm__ __volatile__ ("mov %0, r2" : "=r" (r2));
+    g_mcusr = MCUSR ? MCUSR : r2;
+    MCUSR = 0;
+    wdt_disable();
+}
+
+class superviseur
+{
+public:
+    inline superviseur() : m_cause(RESET_ALIMENTATION), m_debut(0) {}
+
+    inline void demarrer(uint8_t delaiWatchdog = WDTO_500MS);
+    inline void boucle();
+    inline void suspendre();
+    inline void reprendre();
+    inline void preparerReboot();
+
+    inline causeReset cause() const { return m_cause; }
+    inline santeBoucle const & precedent() const { return m_precedent; }
+    inline santeBoucle const & courant() const { return g_santeBoucle; }
+
+    inline void rapport() const;
+
+private:
+    static inline void afficher(santeBoucle const & sante);
+    static inline void remettreAZero(santeBoucle & sante);
+
+private:
+    causeReset    m_cause;          ///< Cause du dernier redémarrage
+    santeBoucle   m_precedent;      ///< Statistiques de la boucle avant le dernier redémarrage
+    unsigned long m_debut;          ///< Instant du dernier passage dans `boucle()` en microsecondes
+    uint8_t       m_delaiWatchdog;  ///< Délai du watchdog (constante WDTO_xxx)
+};
+
+
+
+/**
+ * @brief Démarrer la supervision
+ *
+ * Détermine la cause du dernier redémarrage, conserve les statistiques de la boucle précédente
+ * puis active le watchdog.
+ *
+ * @param delaiWatchdog [In] Délai du watchdog (WDTO_xxx). Il doit couvrir le pire cas de la boucle,
+ *                           délai d'overboost des moteurs compris.
+ */
+inline void superviseur::demarrer(uint8_t delaiWatchdog)
+{
+    bool contenuValide = g_santeBoucle.magic == (EEPROM_MAGIC << 8 | EEPROM_MAGIC);
+
+    if      (g_mcusr & _BV(PORF) || !contenuValide)      m_cause = RESET_ALIMENTATION;
+    else if (g_mcusr & _BV(BORF))                        m_cause = RESET_BROWNOUT;
+    else if (g_mcusr & _BV(WDRF))                        m_cause = g_santeBoucle.rebootDemande ? RESET_DEMANDE : RESET_WATCHDOG;
+    else                                                 m_cause = RESET_EXTERNE;
+
+    if (m_cause == RESET_ALIMENTATION)
+    {
+        remettreAZero(g_santeBoucle);
+        g_santeBoucle.nbWatchdog = 0;
+    }
+    else if (m_cause == RESET_WATCHDOG)
+    {
+        ++g_santeBoucle.nbWatchdog;
+    }
+
+    m_precedent = g_santeBoucle;
+    remettreAZero(g_santeBoucle);
+
+    m_delaiWatchdog = delaiWatchdog;
+    reprendre();
+}
+
+/**
+ * @brief Signaler un tour complet de la boucle principale
+ *
+ * Met à jour les statistiques de période et nourrit le watchdog. À appeler une fois par tour de `loop()`.
+ */
+inline void superviseur::boucle()
+{
+    unsigned long maintenant = micros();
+    unsigned long ecart = maintenant - m_debut;
+    uint16_t periode = ecart > 0xFFFF ? 0xFFFF : ecart;
+    m_debut = maintenant;
+
+    if (periode < g_santeBoucle.periodeMin) g_santeBoucle.periodeMin = periode;
+    if (periode > g_santeBoucle.periodeMax) g_santeBoucle.periodeMax = periode;
+
+    // Moyenne glissante : on divise le cumul par deux quand le compteur sature
+    if (g_santeBoucle.nbPeriodes == 0xFFFF)
+    {
+        g_santeBoucle.periodeSomme >>= 1;
+        g_santeBoucle.nbPeriodes >>= 1;
+    }
+    g_santeBoucle.periodeSomme += periode;
+    ++g_santeBoucle.nbPeriodes;
+
+    wdt_reset();
+}
+
+/**
+ * @brief Suspendre le watchdog avant une opération longue et bloquante (calibration...)
+ */
+inline void superviseur::suspendre() { wdt_disable(); }
+
+/**
+ * @brief Réactiver le watchdog après `suspendre()`
+ */
+inline void superviseur::reprendre()
+{
+    m_debut = micros();
+    wdt_enable(m_delaiWatchdog);
+}
+
+/**
+ * @brief Indiquer que le prochain redémarrage par le watchdog est volontaire
+ */
+inline void superviseur::preparerReboot() { g_santeBoucle.rebootDemande = true; }
+
+/**
+ * @brief Afficher la cause du dernier redémarrage et les statistiques de la boucle sur le port série
+ */
+inline void superviseur::rapport() const
+{
+    Serial.print(F("Dernier reset : "));
+    switch (m_cause)
+    {
+    case RESET_ALIMENTATION: Serial.print(F("alimentation")); break;
+    case RESET_EXTERNE:      Serial.print(F("externe"));      break;
+    case RESET_BROWNOUT:     Serial.print(F("brownout"));     break;
+    case RESET_WATCHDOG:     Serial.print(F("watchdog"));     break;
+    case RESET_DEMANDE:      Serial.print(F("demande"));      break;
+    }
+    Serial.print(F(" (watchdog x"));
+    Serial.print(g_santeBoucle.nbWatchdog);
+    Serial.println(')');
+
+    Serial.print(F("Boucle precedente : "));
+    afficher(m_precedent);
+    Serial.print(F("Boucle courante   : "));
+    afficher(g_santeBoucle);
+}
+
+/**
+ * @brief Afficher les périodes minimale, moyenne et maximale d'une boucle en microsecondes
+ */
+inline void superviseur::afficher(santeBoucle const & sante)
+{
+    Serial.print(F("min "));
+    Serial.print(sante.periodeMin);
+    Serial.print(F(" moy "));
+    Serial.print(sante.nbPeriodes ? sante.periodeSomme / sante.nbPeriodes : 0);
+    Serial.print(F(" max "));
+    Serial.print(sante.periodeMax);
+    Serial.println(F(" us"));
+}
+
+/**
+ * @brief Remettre à zéro les statistiques de période (le compteur de watchdog est conservé)
+ */
+inline void superviseur::remettreAZero(santeBoucle & sante)
+{
+    sante.magic = EEPROM_MAGIC << 8 | EEPROM_MAGIC;
+    sante.periodeMin = 0xFFFF;
+    sante.periodeMax = 0;
+    sante.periodeSomme = 0;
+    sante.nbPeriodes = 0;
+    sante.rebootDemande = false;
+}
+
+#endif
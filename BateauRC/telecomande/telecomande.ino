@@ -8,17 +8,40 @@
  * Il inclut des fonctionnalités pour contrôler la direction du bateau (gauche, droite), calibrer le joystick, envoyer une commande de réinitialisation et redémarrer le système.
  */
 
+//#define TELECOMMANDE_PASSERELLE     // Piloter le bateau depuis un PC branché sur le port série
+//#define TELECOMMANDE_MESURE_ENERGIE // Afficher régulièrement le rapport cyclique et l'autonomie estimée
+//#define TELECOMMANDE_CADENCE_FIXE   // Émettre un message toutes les PERIODE_EMISSION ms, changement ou pas (comparaison)
+//#define TELECOMMANDE_SAUT_FREQUENCE // Changer de canal à chaque créneau (bateau compilé avec BATEAU_SAUT_FREQUENCE)
+
+// En mode passerelle, le port série ne transporte que des paquets binaires
+#ifdef TELECOMMANDE_PASSERELLE
+#undef TELECOMMANDE_MESURE_ENERGIE
+#else
 #define BATEAU_DEBUG
+#endif
+
+// En saut de fréquence, une trame part à chaque créneau
+#ifdef TELECOMMANDE_SAUT_FREQUENCE
+#undef TELECOMMANDE_CADENCE_FIXE
+#endif
 
 #include <SPI.h>
 #include <RF24.h>
 #include <math.h>
 
-#include "common.h"           // Inclure la 
-#include "joypad.h"           // Inclure la bibliothèque joystick
-#include "joystickToMotors.h" // Inclure la bibliothèque de conversion joystick ver moteurs
-#include "radioMessage.h"     // Inclure la définition de la structure du message radio
-#include "reboot.h"           // Inclure la fonction de redémarrage
+#include <ClubElectronique.h> // Inclure la bibliothèque commune du club
+#include <joypad.h>           // Inclure la bibliothèque joystick
+#include <joystickToMotors.h> // Inclure la bibliothèque de conversion joystick ver moteurs
+#include <radioMessage.h>     // Inclure la définition de la structure du message radio
+#include <reboot.h>           // Inclure la fonction de redémarrage
+#include <veille.h>           // Inclure la mise en veille entre deux émissions
+#include <chronoDemarrage.h>  // Inclure la mesure du temps jusqu'au premier message acquitté
+#include <sessionManette.h>   // Inclure le format d'enregistrement des sessions de pilotage
+#include <passerelleSerie.h>  // Inclure le pilotage depuis un PC
+#include <politiqueEmission.h> // Inclure la décision d'émettre sur changement de consigne
+#include <parametres.h>       // Inclure le registre des paramètres réglables en direct
+#include <sondeRadio.h>       // Inclure la mesure du temps d'aller-retour de la liaison
+#include <sautFrequence.h>    // Inclure le saut de fréquence
 
 /**
  * @brief Broche CE (Chip Enable) connectée à l'émetteur-récepteur radio nRF24L01
@@ -30,6 +53,68 @@
  */
 #define CSN_PIN 10
 
+/**
+ * @brief Période d'émission des messages radio en cadence fixe (ms)
+ */
+#define PERIODE_EMISSION 100
+
+/**
+ * @brief Période de lecture du joystick quand l'émission suit les changements de consigne (ms)
+ */
+#define PERIODE_ECHANTILLON 10
+
+/**
+ * @brief Délai maximal entre deux émissions sans changement de consigne (ms)
+ *
+ * La moitié du failsafe du bateau (100ms) : un battement perdu ne suffit pas à le déclencher.
+ */
+#define PERIODE_BATTEMENT 50
+
+/**
+ * @brief Écart de consigne d'un moteur qui déclenche une émission (%)
+ */
+#define SEUIL_EMISSION 3
+
+/**
+ * @brief Graine de la séquence de saut de fréquence, la même sur le bateau et la télécommande
+ */
+#define GRAINE_SAUT 0x4A42
+
+#if defined(TELECOMMANDE_SAUT_FREQUENCE)
+#define PERIODE_CYCLE DUREE_CRENEAU_SAUT
+#elif defined(TELECOMMANDE_CADENCE_FIXE)
+#define PERIODE_CYCLE PERIODE_EMISSION
+#else
+#define PERIODE_CYCLE PERIODE_ECHANTILLON
+#endif
+
+/**
+ * @brief Nombre de sondes par réglage radio de la commande 'L', par défaut
+ */
+#define FENETRE_SONDE 50
+
+/**
+ * @brief Nombre de trames de rafale par réglage radio de la commande 'T', par défaut
+ */
+#define TRAMES_RAFALE 500
+
+/**
+ * @brief Attente maximale du retour d'une sonde (µs)
+ *
+ * Couvre l'émission du retour par le bateau à 250kbps, réémissions comprises.
+ */
+#define ATTENTE_SONDE 30000UL
+
+/**
+ * @brief Période d'affichage du rapport de consommation (ms)
+ */
+#define PERIODE_MESURE_ENERGIE 10000
+
+/**
+ * @brief Longueur maximale d'une ligne de commande reçue sur le port série, les caractères en trop sont ignorés
+ */
+#define LONGUEUR_LIGNE_SERIE 24
+
 /**
  * @brief Objet émetteur-récepteur radio nRF24L01
  */
@@ -70,6 +155,73 @@ uint8_t boutons;
  */
 uint8_t radioPowerLevel = RF24_PA_LOW;
 
+/**
+ * @brief Mise en veille entre deux émissions
+ */
+veille sommeil;
+
+/**
+ * @brief Mesure du temps jusqu'au premier message acquitté par le bateau
+ */
+chronoDemarrage chrono;
+
+/**
+ * @brief Instant du prochain cycle de lecture du joystick (ms)
+ */
+unsigned long prochainCycle = 0;
+
+/**
+ * @brief Décision d'émettre selon les changements de consigne
+ */
+politiqueEmission emission(SEUIL_EMISSION, PERIODE_BATTEMENT);
+
+#ifdef TELECOMMANDE_PASSERELLE
+/**
+ * @brief Commandes reçues du PC sur le port série
+ */
+passerelle pc;
+#endif
+
+#ifdef TELECOMMANDE_SAUT_FREQUENCE
+/**
+ * @brief Séquence de saut de fréquence et liste noire des canaux (commande série 'F')
+ */
+sautFrequence saut(GRAINE_SAUT);
+#endif
+
+/**
+ * @brief Paramètres réglables depuis la console série (commandes 'P', 'W' et 'S')
+ *
+ * Les paramètres du bateau sont ceux envoyés en dernier : la télécommande ne lit pas ceux du bateau.
+ */
+registreParametres parametres;
+
+/**
+ * @brief Paramètres du bateau à envoyer, un bit par identifiant, retirés une fois le message acquitté
+ */
+uint8_t parametresAEnvoyer = 0;
+
+/**
+ * @brief Sauvegarde des paramètres à demander au bateau, une fois tous les paramètres envoyés
+ */
+bool sauvegardeAEnvoyer = false;
+
+/**
+ * @brief Enregistrement de la session de pilotage sur le port série (commande série 'R')
+ */
+bool enregistrement = false;
+
+/**
+ * @brief Instant du dernier échantillon enregistré (ms)
+ */
+unsigned long dernierEchantillon = 0;
+
+/**
+ * @brief Ligne de commande en cours de réception sur le port série, et sa longueur
+ */
+char ligneSerie[LONGUEUR_LIGNE_SERIE + 1];
+uint8_t longueurLigneSerie = 0;
+
 
 /**
  * @brief Fonction de configuration
@@ -79,9 +231,12 @@ uint8_t radioPowerLevel = RF24_PA_LOW;
  */
 void setup()
 {
-  delay(1000); 
+  // Pas d'attente du port série : sans hôte USB, `while (!Serial)` bloquerait la télécommande
+#ifdef TELECOMMANDE_PASSERELLE
+  Serial.begin(PASSERELLE_BAUD); // Initialiser la liaison avec le PC
+#else
   Serial.begin(115200); // Initialiser la communication série pour le débogage
-  while (!Serial) {} // some boards need to wait to ensure access to serial over USB  
+#endif
 
   if (!radio.begin())
   {
@@ -106,7 +261,16 @@ void setup()
 
   radio.stopListening();               // Démarrer la possibilité d'envois de messages radio
 
+#ifdef TELECOMMANDE_SAUT_FREQUENCE
+  // Une trame non acquittée est abandonnée avant la fin de son créneau (3 réémissions espacées de 500µs) :
+  // la suivante part sur un autre canal
+  radio.setRetries(1, 3);
+#endif
+
   manette.lightCalibration();
+
+  parametres.charger();
+  jm.setAngleSeuil(parametres.lire(PARAM_ANGLE_SEUIL));
 }
 
 /**
@@ -136,6 +300,12 @@ void loop()
      * @brief Lit le masque binaire des boutons pressés
      */
     boutons = manette.getButton();
+    uint8_t appuis = boutons & manette.changed(); // Boutons qui viennent d'être pressés
+
+    if (enregistrement)
+    {
+        enregistrerEchantillon(x, y, boutons);
+    }
 
     jm.convert(x, y, g, d);
     msg.gauche = g;
@@ -161,7 +331,7 @@ void loop()
         msg.gauche = 100;
         msg.droit = -100;
     }
-    if (boutons & maskBoutonC)
+    if (appuis & maskBoutonC)
     {
         debugln("Bouton C");
         radioPowerLevel = (radioPowerLevel + 1) % 4;
@@ -190,7 +360,7 @@ void loop()
         debugln("Bouton F");
         reboot();
     }
-    if (boutons & maskBoutonK)
+    if (appuis & maskBoutonK)
     {
         debugln("Bouton K");
         mapping = (joystickToMotors::mapping)((uint8_t)(mapping+1) % joystickToMotors::mappinEnumSize);
@@ -200,13 +370,492 @@ void loop()
 
     }
 
-    assignCheck(msg);
-    /**
-     * @brief Evoi le message radio au bateau
-     */
-    if (!radio.write(&msg, sizeof(msg)))
+#ifdef TELECOMMANDE_PASSERELLE
+    // La dernière commande du PC remplace celle du joystick tant qu'elle est récente
+    pc.recevoir(Serial, millis());
+    bool commandePC = pc.commande(msg, millis());
+#endif
+
+    // Un paramètre en attente remplace la consigne des moteurs le temps d'un message
+    uint8_t parametreEmis = preparerParametre(msg);
+
+#if defined(TELECOMMANDE_SAUT_FREQUENCE)
+    // Sinon, une annonce de liste noire en attente
+    bool annonce = parametreEmis == 0xFF && saut.preparerAnnonce(msg);
+    bool emettre = true;
+#elif defined(TELECOMMANDE_CADENCE_FIXE)
+    bool emettre = true;
+#else
+    bool emettre = emission.aEmettre(msg, boutons, millis());
+#endif
+#ifdef TELECOMMANDE_PASSERELLE
+    // Le PC a sa propre cadence : ses commandes partent à chaque cycle, sans attendre un écart de consigne
+    emettre = emettre || commandePC;
+#endif
+
+    if (emettre)
+    {
+      ++msg.seq; // Un trou dans la séquence indique au bateau une trame perdue
+      assignCheck(msg);
+#ifdef TELECOMMANDE_SAUT_FREQUENCE
+      radio.setChannel(saut.canal(msg.seq)); // Le numéro de séquence est celui du créneau
+#endif
+      /**
+       * @brief Evoi le message radio au bateau
+       */
+      bool acquitte = radio.write(&msg, sizeof(msg));
+      if (acquitte)
+      {
+        chrono.trameValide();
+        parametreAcquitte(parametreEmis);
+      }
+#ifdef TELECOMMANDE_SAUT_FREQUENCE
+      if (annonce && acquitte) saut.annonceAcquittee(msg);
+      saut.emise(msg.seq, acquitte);
+#endif
+      emission.emis(msg, boutons, millis());
+
+#ifdef TELECOMMANDE_PASSERELLE
+      pc.compteRendu(Serial, commandePC, acquitte);
+#endif
+    }
+
+#ifndef TELECOMMANDE_PASSERELLE
+    // Traiter les commandes reçues sur le port série
+    recevoirCommandeSerie();
+#endif
+
+    attendreProchainCycle();
+}
+
+/**
+ * @brief Accumuler les caractères reçus sur le port série et traiter chaque ligne complète
+ *
+ * Ne lit que ce qui est déjà arrivé : une commande à arguments ("W <id> <valeur>") n'arrête jamais
+ * l'émission, contrairement à `Serial.parseInt()` qui attend jusqu'à une seconde et déclenchait le
+ * failsafe du bateau. Chaque commande se termine par un retour à la ligne.
+ */
+void recevoirCommandeSerie()
+{
+  while (Serial.available())
+  {
+    char caractere = Serial.read();
+    if (caractere != '\n' && caractere != '\r')
+    {
+      if (longueurLigneSerie < LONGUEUR_LIGNE_SERIE) ligneSerie[longueurLigneSerie++] = caractere;
+      continue;
+    }
+    if (!longueurLigneSerie) continue; // "\r\n", ou ligne vide
+
+    ligneSerie[longueurLigneSerie] = '\0';
+    longueurLigneSerie = 0;
+    commandeSerie(ligneSerie);
+  }
+}
+
+/**
+ * @brief Lire l'argument entier suivant d'une ligne de commande
+ * @param position [In,Out] Position dans la ligne, avancée après l'argument
+ * @return La valeur de l'argument, 0 s'il n'y en a plus
+ */
+long argumentSerie(char const *& position)
+{
+  char * fin;
+  long valeur = strtol(position, &fin, 10);
+  position = fin;
+  return valeur;
+}
+
+/**
+ * @brief Fonction pour traiter une ligne de commande reçue sur le port série
+ * @param ligne La ligne reçue : une lettre de commande, puis ses arguments éventuels
+ */
+void commandeSerie(char const * ligne)
+{
+  char const * arguments = ligne + 1;
+  switch (toupper(ligne[0]))
+  {
+  case 'R': // Démarrer ou arrêter l'enregistrement de la session de pilotage
+    enregistrement = !enregistrement;
+    dernierEchantillon = millis();
+    break;
+  case 'P': // Liste des paramètres
+    parametres.afficher(Serial);
+    break;
+  case 'W': // Modifier un paramètre : "W <id> <valeur>"
+  {
+    long id = argumentSerie(arguments);
+    long valeur = argumentSerie(arguments);
+    ecrireParametre(id, valeur);
+    break;
+  }
+  case 'S': // Sauvegarder les paramètres en EEPROM, ici et sur le bateau
+    parametres.sauver();
+    sauvegardeAEnvoyer = true;
+    Serial.println(F("Parametres sauvegardes"));
+    break;
+  case 'D': // Durée des derniers démarrages jusqu'au premier message acquitté par le bateau
+    chrono.rapport();
+    break;
+#ifdef TELECOMMANDE_SAUT_FREQUENCE
+  case 'F': // Séquence de saut de fréquence : canaux, liste noire et pertes en cours
+    saut.afficher(Serial);
+    break;
+  case 'T':
+  case 'L': // Les mesures de la liaison se font sur un canal fixe
+    Serial.println(F("Indisponible en saut de frequence"));
+    break;
+#else
+  case 'T': // Test de la liaison par rafales à chaque puissance et débit : "T <trames par réglage>"
+  {
+    long nb = argumentSerie(arguments);
+    testerLiaison(nb > 0 && nb <= 0xFFFF ? nb : TRAMES_RAFALE);
+    break;
+  }
+  case 'L': // Temps d'aller-retour à chaque puissance et débit : "L <sondes par réglage>"
+  {
+    long fenetre = argumentSerie(arguments);
+    mesurerLatence(fenetre > 0 && fenetre <= FENETRE_SONDE_MAX ? fenetre : FENETRE_SONDE);
+    break;
+  }
+#endif
+  }
+}
+
+/**
+ * @brief Mesurer le temps d'aller-retour et les pertes de la liaison à chaque puissance et débit
+ *
+ * Pour chaque réglage, le bateau est d'abord réglé par une trame acquittée, puis reçoit `fenetre` sondes
+ * qu'il renvoie aussitôt ; ses moteurs restent arrêtés. Une ligne par réglage : débit, puissance, sondes
+ * émises, pertes (%), minimum, médiane et 99e centile (µs). Les deux radios reviennent ensuite aux
+ * réglages courants.
+ *
+ * @param fenetre Nombre de sondes par réglage
+ */
+void mesurerLatence(uint8_t fenetre)
+{
+  Serial.println(F("debit\tpuiss\tsondes\tperte%\tmin\tmediane\tp99 (us)"));
+  for (uint8_t debit = 0; debit < NB_DEBITS; ++debit)
+  {
+    for (uint8_t puissance = 0; puissance < NB_PUISSANCES; ++puissance)
+    {
+      afficherDebit(Serial, debit);
+      Serial.print('\t');
+      afficherPuissance(Serial, puissance);
+      Serial.print('\t');
+      if (!reglerRadio(puissance, debit))
+      {
+        Serial.println(F("reglage non acquitte"));
+        retablirRadio();
+        continue;
+      }
+
+      statistiquesLatence stats;
+      for (uint8_t i = 0; i < fenetre; ++i)
+      {
+        sonder(stats);
+      }
+      stats.afficher(Serial);
+      retablirRadio();
+    }
+  }
+}
+
+/**
+ * @brief Tester la liaison avec le bateau à chaque puissance et débit, avant une sortie
+ *
+ * Pour chaque réglage, le bateau est d'abord réglé par une trame acquittée (qui remet ses compteurs à
+ * zéro), puis reçoit `nb` trames de rafale émises aussi vite que la radio le permet, et renvoie enfin le
+ * nombre de trames reçues et de trames invalides ; ses moteurs restent arrêtés. Une ligne par réglage :
+ * débit, puissance, trames/s, pertes (%), réémissions moyennes par trame et trames invalides. Les deux
+ * radios reviennent ensuite aux réglages courants.
+ *
+ * @param nb Nombre de trames de rafale par réglage
+ */
+void testerLiaison(uint16_t nb)
+{
+  Serial.println(F("debit\tpuiss\ttrames/s\tperte%\treemis.\tinvalides"));
+  for (uint8_t debit = 0; debit < NB_DEBITS; ++debit)
+  {
+    for (uint8_t puissance = 0; puissance < NB_PUISSANCES; ++puissance)
+    {
+      afficherDebit(Serial, debit);
+      Serial.print('\t');
+      afficherPuissance(Serial, puissance);
+      Serial.print('\t');
+      if (!reglerRadio(puissance, debit))
+      {
+        Serial.println(F("reglage non acquitte"));
+        retablirRadio();
+        continue;
+      }
+
+      mesureRafale mesure = {};
+      radioMessage trame;
+      preparerRafale(trame, SONDE_RAFALE);
+      unsigned long debut = micros();
+      for (mesure.emises = 0; mesure.emises < nb; ++mesure.emises)
+      {
+        trame.seq = ++msg.seq;
+        assignCheck(trame);
+        if (radio.write(&trame, sizeof(trame))) ++mesure.acquittees;
+        mesure.reemissions += radio.getARC();
+      }
+      mesure.duree = micros() - debut;
+
+      if (demanderBilan(mesure))
+      {
+        mesure.afficher(Serial);
+      }
+      else
+      {
+        Serial.println(F("bilan perdu"));
+      }
+      retablirRadio();
+    }
+  }
+}
+
+/**
+ * @brief Demander au bateau ses compteurs de rafale, en trois essais au plus
+ *
+ * @param mesure Mesure complétée par les trames reçues et invalides du bateau
+ * @return true si le bilan a été reçu
+ */
+bool demanderBilan(mesureRafale & mesure)
+{
+  for (uint8_t essai = 0; essai < 3; ++essai)
+  {
+    radioMessage demande;
+    preparerRafale(demande, SONDE_BILAN);
+    demande.seq = ++msg.seq;
+    assignCheck(demande);
+    if (!radio.write(&demande, sizeof(demande))) continue;
+
+    radioMessage bilan;
+    if (attendreRetour(bilan) && estBilan(bilan))
+    {
+      compteurRafale::lireBilan(bilan, mesure.recues, mesure.invalides);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Émettre une sonde et attendre son retour
+ *
+ * @param stats Statistiques complétées par le temps d'aller-retour ou par une perte
+ */
+void sonder(statistiquesLatence & stats)
+{
+  radioMessage sonde;
+  ++msg.seq;
+  sonde.seq = msg.seq;
+  preparerSonde(sonde, micros());
+  assignCheck(sonde);
+
+  if (!radio.write(&sonde, sizeof(sonde)))
+  {
+    stats.perdue();
+    return;
+  }
+
+  radioMessage retour;
+  if (attendreRetour(retour) && estSonde(retour) && retour.seq == sonde.seq && horodatageSonde(retour) == horodatageSonde(sonde))
+  {
+    stats.ajouter((uint16_t)micros() - horodatageSonde(sonde));
+  }
+  else
+  {
+    stats.perdue();
+  }
+}
+
+/**
+ * @brief Attendre la réponse du bateau à une trame sonde, ATTENTE_SONDE µs au plus
+ *
+ * @param retour Trame reçue
+ * @return true si une trame valide a été reçue
+ */
+bool attendreRetour(radioMessage & retour)
+{
+  radio.startListening();
+  unsigned long debut = micros();
+  bool recu = false;
+  while (!recu && micros() - debut < ATTENTE_SONDE)
+  {
+    if (!radio.available()) continue;
+
+    radio.read(&retour, sizeof(retour));
+    recu = messageIsValid(retour);
+  }
+  radio.stopListening();
+  return recu;
+}
+
+/**
+ * @brief Passer le bateau puis la télécommande à une puissance et un débit
+ *
+ * @param puissance Puissance (RF24_PA_MIN à RF24_PA_MAX)
+ * @param debit     Débit (rf24_datarate_e)
+ * @return true si le bateau a acquitté le changement
+ */
+bool reglerRadio(uint8_t puissance, uint8_t debit)
+{
+  radioMessage reglage;
+  ++msg.seq;
+  reglage.seq = msg.seq;
+  preparerReglage(reglage, puissance, debit);
+  assignCheck(reglage);
+
+  if (!radio.write(&reglage, sizeof(reglage))) return false;
+
+  radio.setPALevel(puissance);
+  radio.setDataRate((rf24_datarate_e)debit);
+  return true;
+}
+
+/**
+ * @brief Revenir aux réglages courants de la liaison, des deux côtés
+ *
+ * Si le bateau n'acquitte pas, la télécommande revient seule à ses réglages et attend que le bateau,
+ * privé de trames, y revienne aussi.
+ */
+void retablirRadio()
+{
+  if (reglerRadio(radioPowerLevel, DEBIT_DEMARRAGE)) return;
+
+  radio.setPALevel(radioPowerLevel);
+  radio.setDataRate((rf24_datarate_e)DEBIT_DEMARRAGE);
+  delay(DELAI_REGLAGE_SONDE + 100);
+}
+
+/**
+ * @brief Modifier un paramètre depuis la console
+ *
+ * Un paramètre de la télécommande est appliqué tout de suite, un paramètre du bateau lui est envoyé
+ * au prochain message.
+ *
+ * @param id     Identifiant du paramètre
+ * @param valeur Nouvelle valeur
+ */
+void ecrireParametre(long id, long valeur)
+{
+  if (id < 0 || id >= NB_PARAMETRES || valeur < 0 || valeur > 255 || !parametres.ecrire(id, valeur))
+  {
+    Serial.println(F("Parametre ou valeur invalide"));
+    return;
+  }
+
+  if (registreParametres::description(id).bateau)
+  {
+    parametresAEnvoyer |= 1 << id;
+  }
+  else if (id == PARAM_ANGLE_SEUIL)
+  {
+    jm.setAngleSeuil(valeur);
+  }
+
+  registreParametres::afficherNom(Serial, id);
+  Serial.print(F(" = "));
+  Serial.println(valeur);
+}
+
+/**
+ * @brief Placer le premier paramètre en attente dans le message radio
+ *
+ * @param message Message à émettre
+ * @return L'identifiant du paramètre placé, NB_PARAMETRES pour une demande de sauvegarde seule, 0xFF si rien
+ */
+uint8_t preparerParametre(radioMessage & message)
+{
+  uint8_t id = 0;
+  while (id < NB_PARAMETRES && !(parametresAEnvoyer & (1 << id))) ++id;
+
+  if (id == NB_PARAMETRES && !sauvegardeAEnvoyer) return 0xFF;
+
+  message.cmd |= radioCmd::PARAM;
+  if (id == NB_PARAMETRES) message.cmd |= radioCmd::PARAM_SAUVER;
+  message.gauche = id;
+  message.droit  = id < NB_PARAMETRES ? parametres.lire(id) : 0;
+  return id;
+}
+
+/**
+ * @brief Retirer de l'attente le paramètre que le bateau vient d'acquitter
+ *
+ * @param id Valeur rendue par `preparerParametre`
+ */
+void parametreAcquitte(uint8_t id)
+{
+  if (id < NB_PARAMETRES)       parametresAEnvoyer &= ~(1 << id);
+  else if (id == NB_PARAMETRES) sauvegardeAEnvoyer = false;
+}
+
+/**
+ * @brief Envoie un échantillon de la manette sur le port série
+ *
+ * Le paquet binaire est rejoué sur PC par `rejeu_session` (bibliothèque ClubElectronique, extras/hote).
+ *
+ * @param x       Axe X du joystick
+ * @param y       Axe Y du joystick
+ * @param boutons Masque des boutons pressés
+ */
+void enregistrerEchantillon(int8_t x, int8_t y, uint8_t boutons)
+{
+  unsigned long maintenant = millis();
+  unsigned long dt = maintenant - dernierEchantillon;
+  dernierEchantillon = maintenant;
+
+  echantillonManette e = { (uint16_t)(dt > 0xFFFF ? 0xFFFF : dt), x, y, boutons };
+  uint8_t paquet[TAILLE_PAQUET_SESSION];
+  encoderEchantillon(paquet, e);
+  Serial.write(paquet, sizeof(paquet));
+}
+
+/**
+ * @brief Endort la télécommande jusqu'au prochain cycle
+ *
+ * Le microcontrôleur est mis en veille entre deux cycles (en mode passerelle, il se réveille aussi à chaque
+ * octet reçu du PC). Les cycles restent cadencés à PERIODE_CYCLE même si le traitement d'une boucle prend du
+ * temps, sauf après un long traitement (calibration...) où l'échéancier repart de l'instant présent.
+ *
+ * En cadence fixe, la radio est éteinte pendant l'attente. Sinon elle reste en attente (standby, 26µA) :
+ * son réveil de plusieurs millisecondes retarderait chaque émission déclenchée par le joystick.
+ */
+void attendreProchainCycle()
+{
+    prochainCycle += PERIODE_CYCLE;
+    if ((long)(millis() - prochainCycle) > 0)
+    {
+        prochainCycle = millis();
+    }
+
+#ifdef TELECOMMANDE_CADENCE_FIXE
+    radio.powerDown();
+#endif
+#ifdef TELECOMMANDE_PASSERELLE
+    // Le port série est vidé à chaque réveil : son tampon de 64 octets se remplit en 1,3ms à 500kbauds
+    while ((long)(prochainCycle - millis()) > 0)
+    {
+      pc.recevoir(Serial, millis());
+      sommeil.sieste();
+    }
+#else
+    sommeil.dormirJusqua(prochainCycle);
+#endif
+#ifdef TELECOMMANDE_CADENCE_FIXE
+    radio.powerUp();
+#endif
+
+#ifdef TELECOMMANDE_MESURE_ENERGIE
+    static unsigned long prochaineMesure = PERIODE_MESURE_ENERGIE;
+    if ((long)(millis() - prochaineMesure) >= 0)
     {
-      //Serial.println(F("msg not send"));
+        sommeil.rapport();
+        sommeil.demarrerMesure();
+        prochaineMesure += PERIODE_MESURE_ENERGIE;
     }
-    delay(100);
+#endif
 }
@@ -0,0 +1,160 @@
+/**
+ * @file ordonnanceur.h
+ * @brief Définit un ordonnanceur coopératif à tâches périodiques et des séquences d'actions minutées.
+ *
+ * Aucune fonction ne bloque : chaque tâche fait un peu de travail puis rend la main. Le temps est toujours
+ * passé en paramètre (`millis()` sur le robot), ce qui permet de dérouler un comportement sur une horloge
+ * virtuelle.
+ */
+
+#pragma once
+#ifndef ORDONNANCEUR_h
+#define ORDONNANCEUR_h
+
+#include "Arduino.h"
+
+#define NB_TACHES_MAX 6 ///< Nombre maximal de tâches périodiques
+
+/**
+ * @brief Tâche périodique : reçoit l'instant présent
+ */
+typedef void (*tache)(unsigned long maintenant);
+
+/**
+ * @brief Action d'une étape de séquence
+ */
+typedef void (*action)();
+
+/**
+ * @brief Etape d'une séquence : une action immédiate suivie d'une attente
+ */
+typedef struct
+{
+    action   faire;  ///< Action exécutée au début de l'étape
+    uint16_t duree;  ///< Durée de l'étape avant de passer à la suivante (ms)
+} etape;
+
+class ordonnanceur
+{
+public:
+    inline ordonnanceur() : m_nbTaches(0) {}
+
+    inline bool ajouter(tache fonction, unsigned long periode, unsigned long maintenant = 0);
+    inline void executer(unsigned long maintenant);
+
+private:
+    struct
+    {
+        tache         fonction;   ///< Fonction de la tâche
+        unsigned long periode;    ///< Période de la tâche (ms)
+        unsigned long prochaine;  ///< Instant de la prochaine exécution (ms)
+    } m_taches[NB_TACHES_MAX];
+    uint8_t m_nbTaches;           ///< Nombre de tâches enregistrées
+};
+
+class sequence
+{
+public:
+    inline sequence(etape const * etapes, uint8_t nbEtapes) : m_etapes(etapes), m_nbEtapes(nbEtapes), m_courante(nbEtapes), m_fin(0) {}
+
+    inline void lancer(unsigned long maintenant);
+    inline void avancer(unsigned long maintenant);
+    inline void interrompre() { m_courante = m_nbEtapes; }
+    inline bool enCours() const { return m_courante < m_nbEtapes; }
+
+private:
+    inline void commencerEtape(unsigned long debut);
+
+private:
+    etape const * m_etapes;    ///< Etapes de la séquence
+    uint8_t       m_nbEtapes;  ///< Nombre d'étapes
+    uint8_t       m_courante;  ///< Etape en cours (m_nbEtapes si la séquence est terminée)
+    unsigned long m_fin;       ///< Instant de fin de l'étape en cours (ms)
+};
+
+
+
+/**
+ * @brief Enregistrer une tâche périodique
+ *
+ * @param fonction   [In] Fonction à appeler
+ * @param periode    [In] Période d'appel (ms)
+ * @param maintenant [In] Instant présent : la première exécution a lieu tout de suite
+ * @return false si la table des tâches est pleine
+ */
+inline bool ordonnanceur::ajouter(tache fonction, unsigned long periode, unsigned long maintenant)
+{
+    if (m_nbTaches >= NB_TACHES_MAX) return false;
+
+    m_taches[m_nbTaches].fonction = fonction;
+    m_taches[m_nbTaches].periode = periode;
+    m_taches[m_nbTaches].prochaine = maintenant;
+    ++m_nbTaches;
+    return true;
+}
+
+/**
+ * @brief Exécuter une fois chaque tâche arrivée à échéance
+ *
+ * L'échéance suivante est calculée à partir de l'échéance prévue, pas de l'instant d'exécution, pour
+ * garder une cadence fixe. Une tâche en retard de plus d'une période repart de l'instant présent.
+ *
+ * @param maintenant [In] Instant présent (ms)
+ */
+inline void ordonnanceur::executer(unsigned long maintenant)
+{
+    for (uint8_t i = 0; i < m_nbTaches; ++i)
+    {
+        if ((long)(maintenant - m_taches[i].prochaine) < 0) continue;
+
+        m_taches[i].fonction(maintenant);
+
+        m_taches[i].prochaine += m_taches[i].periode;
+        if ((long)(maintenant - m_taches[i].prochaine) >= 0)
+        {
+            m_taches[i].prochaine = maintenant + m_taches[i].periode;
+        }
+    }
+}
+
+/**
+ * @brief Lancer la séquence depuis sa première étape
+ *
+ * @param maintenant [In] Instant présent (ms)
+ */
+inline void sequence::lancer(unsigned long maintenant)
+{
+    m_courante = 0;
+    commencerEtape(maintenant);
+}
+
+/**
+ * @brief Passer aux étapes suivantes dont l'heure est venue
+ *
+ * Les étapes s'enchaînent à partir de leur instant de fin prévu, pour ne pas accumuler de retard.
+ *
+ * @param maintenant [In] Instant présent (ms)
+ */
+inline void sequence::avancer(unsigned long maintenant)
+{
+    while (enCours() && (long)(maintenant - m_fin) >= 0)
+    {
+        ++m_courante;
+        if (enCours())
+        {
+            commencerEtape(m_fin);
+        }
+    }
+}
+
+/**
+ * @brief Exécuter l'action de l'étape courante et programmer sa fin
+ */
+inline void sequence::commencerEtape(unsigned long debut)
+{
+    etape const & e = m_etapes[m_courante];
+    if (e.faire) e.faire();
+    m_fin = debut + e.duree;
+}
+
+#endif
@@ -1,8 +1,9 @@
 
 // include the Servo library
 #include <Servo.h>
-#include "Ultrasonic.h"
-Ultrasonic ultrasonic(7, 8); // Trig et Echo
+#include "sonar.h"
+#include "ordonnanceur.h"
+sonar ultrasonic(7, 8); // Trig et Echo, mesures sous interruption
 Servo bras_servo;
 
 #define speakerPin 4
@@ -11,34 +12,62 @@ Servo bras_servo;
 
 int dist = 20;
 
-void setup() {
-  bras_servo.attach(5);
-  pinMode(redPin, OUTPUT);
-  pinMode(greenPin, OUTPUT);
+// Réaction à un obstacle : alarme puis mouvement du bras, sans bloquer la boucle
+void alarme() {
   digitalWrite(redPin, HIGH);  
   digitalWrite(greenPin, LOW);
-  ultrasonic.read(CM);
+  tone(speakerPin, 330); 
 }
+void finAlarme() {
+  noTone(speakerPin);
+  digitalWrite(redPin, LOW);
+}
+void brasHaut()   { bras_servo.write(160); }
+void brasMilieu() { bras_servo.write(90); }
+void brasBas()    { bras_servo.write(0); }
+
+etape const etapesReaction[] = {
+  { alarme,     1000 },
+  { finAlarme,   150 },
+  { brasHaut,    300 },
+  { brasMilieu, 1000 },
+  { brasBas,       0 },
+};
+sequence reaction(etapesReaction, sizeof(etapesReaction) / sizeof(etapesReaction[0]));
+
+ordonnanceur taches;
+
+// Tâche de détection : lance la réaction, sinon signale la voie libre
+void detection(unsigned long maintenant) {
+  dist = ultrasonic.distance();
+  if (reaction.enCours()) return;
 
-void loop() {
-  dist = ultrasonic.read(CM);
   if (dist < 20) {
-    digitalWrite(redPin, HIGH);  
-    digitalWrite(greenPin, LOW);
-    tone(speakerPin, 330); 
-    delay(1000);
-    noTone(speakerPin);
-    digitalWrite(redPin, LOW);
-    delay(150);
-    bras_servo.write(160);
-    delay(300);
-    bras_servo.write(90);
-    delay(1000);
-    bras_servo.write(0);
+    reaction.lancer(maintenant);
   } else {
     noTone(speakerPin);
     digitalWrite(redPin, LOW);
     digitalWrite(greenPin, HIGH);
-    }; 
-  delay(1000);    // needs time for capteur ultrason    
+  }
+}
+
+// Tâche de déroulement de la réaction
+void comportement(unsigned long maintenant) {
+  reaction.avancer(maintenant);
+}
+
+void setup() {
+  bras_servo.attach(5);
+  pinMode(redPin, OUTPUT);
+  pinMode(greenPin, OUTPUT);
+  digitalWrite(redPin, HIGH);  
+  digitalWrite(greenPin, LOW);
+  ultrasonic.demarrer();
+
+  taches.ajouter(detection, SONAR_PERIODE, millis());
+  taches.ajouter(comportement, 10, millis());
+}
+
+void loop() {
+  taches.executer(millis());
 }
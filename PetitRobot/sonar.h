@@ -0,0 +1,202 @@
+/**
+ * @file sonar.h
+ * @brief Définit la classe `sonar` pour mesurer une distance avec un capteur à ultrasons sans bloquer le programme.
+ *
+ * Les impulsions de déclenchement sont envoyées depuis l'interruption de comparaison B du timer 0 (celui de
+ * `millis()`, qui tourne déjà toutes les 1,024ms) et la durée de l'écho est mesurée par une interruption de
+ * changement d'état sur la broche Echo. Les dernières mesures passent par un filtre médian : `distance()`
+ * rend immédiatement la dernière valeur filtrée.
+ *
+ * La broche Echo doit être sur le port B (broches 8 à 13) : l'interruption utilisée est PCINT0.
+ */
+
+#pragma once
+#ifndef SONAR_h
+#define SONAR_h
+
+#include "Arduino.h"
+
+#define SONAR_NB_MESURES  5      ///< Nombre de mesures du filtre médian (impair)
+#define SONAR_PERIODE     30     ///< Période des déclenchements en ticks du timer 0 (environ 1ms), écho maximal compris
+#define SONAR_ECHO_MAX    25000  ///< Durée d'écho au-delà de laquelle l'obstacle est considéré hors de portée (µs)
+#define SONAR_US_PAR_CM   56     ///< Durée d'aller-retour du son pour 1cm (µs)
+
+class sonar
+{
+public:
+    inline sonar(uint8_t trig, uint8_t echo);
+
+    inline void demarrer();
+    inline unsigned int distance();
+    inline uint16_t nbMesures() const { return m_nbMesures; }
+
+    inline void top();
+    inline void front();
+
+    static sonar * s_instance; ///< Instance servie par les interruptions
+
+private:
+    inline void enregistrer(uint16_t duree);
+
+private:
+    uint8_t           m_trig;                       ///< Broche de déclenchement
+    uint8_t           m_echo;                       ///< Broche d'écho
+    volatile uint8_t* m_registreEcho;               ///< Registre d'entrée du port de la broche d'écho
+    uint8_t           m_masqueEcho;                 ///< Masque de la broche d'écho dans son port
+    uint8_t           m_decompte;                   ///< Ticks restants avant le prochain déclenchement
+    unsigned long     m_debutEcho;                  ///< Instant du front montant de l'écho (µs)
+    bool              m_echoEnCours;                ///< Un front montant a été vu, on attend le front descendant
+    volatile uint16_t m_mesures[SONAR_NB_MESURES];  ///< Dernières durées d'écho (µs)
+    volatile uint8_t  m_index;                      ///< Prochaine case à remplir dans `m_mesures`
+    volatile bool     m_nouvelle;                   ///< Une mesure est arrivée depuis le dernier calcul
+    volatile uint16_t m_nbMesures;                  ///< Nombre total de mesures (pour vérifier la cadence)
+    unsigned int      m_distance;                   ///< Dernière distance filtrée (cm)
+};
+
+sonar * sonar::s_instance = nullptr;
+
+/**
+ * @brief Interruption du timer 0 : cadence des déclenchements
+ */
+ISR(TIMER0_COMPB_vect)
+{
+    if (sonar::s_instance) sonar::s_instance->top();
+}
+
+/**
+ * @brief Interruption de changement d'état du port B : fronts de l'écho
+ */
+ISR(PCINT0_vect)
+{
+    if (sonar::s_instance) sonar::s_instance->front();
+}
+
+
+
+/**
+ * @brief Constructeur de la classe sonar
+ *
+ * @param trig Broche de déclenchement du capteur
+ * @param echo Broche d'écho du capteur (port B)
+ */
+inline sonar::sonar(uint8_t trig, uint8_t echo)
+    : m_trig(trig), m_echo(echo), m_decompte(1), m_debutEcho(0), m_echoEnCours(false),
+      m_index(0), m_nouvelle(false), m_nbMesures(0), m_distance(SONAR_ECHO_MAX / SONAR_US_PAR_CM)
+{
+    for (uint8_t i = 0; i < SONAR_NB_MESURES; ++i)
+    {
+        m_mesures[i] = SONAR_ECHO_MAX;
+    }
+}
+
+/**
+ * @brief Configurer les broches et les interruptions, puis lancer les mesures
+ */
+inline void sonar::demarrer()
+{
+    pinMode(m_trig, OUTPUT);
+    digitalWrite(m_trig, LOW);
+    pinMode(m_echo, INPUT);
+
+    m_registreEcho = portInputRegister(digitalPinToPort(m_echo));
+    m_masqueEcho = digitalPinToBitMask(m_echo);
+
+    s_instance = this;
+
+    // Changement d'état de la broche d'écho
+    *digitalPinToPCMSK(m_echo) |= _BV(digitalPinToPCMSKbit(m_echo));
+    PCICR |= _BV(digitalPinToPCICRbit(m_echo));
+
+    // Comparaison B du timer 0, à mi-période pour ne pas coïncider avec le débordement de millis()
+    OCR0B = 0x80;
+    TIMSK0 |= _BV(OCIE0B);
+}
+
+/**
+ * @brief Dernière distance filtrée
+ *
+ * Le filtre médian n'est recalculé que si une nouvelle mesure est arrivée.
+ *
+ * @return La distance en centimètres (SONAR_ECHO_MAX / SONAR_US_PAR_CM si rien n'est à portée)
+ */
+inline unsigned int sonar::distance()
+{
+    if (!m_nouvelle) return m_distance;
+
+    uint16_t tri[SONAR_NB_MESURES];
+    noInterrupts();
+    for (uint8_t i = 0; i < SONAR_NB_MESURES; ++i)
+    {
+        tri[i] = m_mesures[i];
+    }
+    m_nouvelle = false;
+    interrupts();
+
+    // Tri par insertion : 5 valeurs
+    for (uint8_t i = 1; i < SONAR_NB_MESURES; ++i)
+    {
+        uint16_t valeur = tri[i];
+        uint8_t j = i;
+        while (j > 0 && tri[j - 1] > valeur)
+        {
+            tri[j] = tri[j - 1];
+            --j;
+        }
+        tri[j] = valeur;
+    }
+
+    m_distance = tri[SONAR_NB_MESURES / 2] / SONAR_US_PAR_CM;
+    return m_distance;
+}
+
+/**
+ * @brief Tick du timer 0 : déclencher une mesure toutes les SONAR_PERIODE ticks
+ *
+ * Un écho toujours en cours au moment du déclenchement suivant est compté hors de portée.
+ */
+inline void sonar::top()
+{
+    if (--m_decompte) return;
+    m_decompte = SONAR_PERIODE;
+
+    if (m_echoEnCours)
+    {
+        m_echoEnCours = false;
+        enregistrer(SONAR_ECHO_MAX);
+    }
+
+    digitalWrite(m_trig, HIGH);
+    delayMicroseconds(10);
+    digitalWrite(m_trig, LOW);
+}
+
+/**
+ * @brief Front sur la broche d'écho : mesurer la durée de l'impulsion
+ */
+inline void sonar::front()
+{
+    if (*m_registreEcho & m_masqueEcho)
+    {
+        m_debutEcho = micros();
+        m_echoEnCours = true;
+    }
+    else if (m_echoEnCours)
+    {
+        unsigned long duree = micros() - m_debutEcho;
+        m_echoEnCours = false;
+        enregistrer(duree > SONAR_ECHO_MAX ? SONAR_ECHO_MAX : duree);
+    }
+}
+
+/**
+ * @brief Ranger une durée d'écho dans le tampon du filtre médian
+ */
+inline void sonar::enregistrer(uint16_t duree)
+{
+    m_mesures[m_index] = duree;
+    m_index = (m_index + 1) % SONAR_NB_MESURES;
+    m_nouvelle = true;
+    ++m_nbMesures;
+}
+
+#endif
@@ -0,0 +1,56 @@
+/**
+ * @file banc.h
+ * @brief Outils communs aux bancs d'essai sur PC : chronométrage et empreinte des résultats.
+ *
+ * Chaque banc affiche le temps moyen par appel et une empreinte des sorties calculées. L'empreinte doit
+ * rester identique d'une optimisation à l'autre : seul le temps a le droit de changer.
+ */
+
+#pragma once
+#ifndef BANC_h
+#define BANC_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+
+/**
+ * @brief Empreinte FNV-1a des sorties d'un banc
+ */
+class empreinte
+{
+public:
+    empreinte() : m_valeur(2166136261u) {}
+
+    void ajouter(uint8_t octet) { m_valeur = (m_valeur ^ octet) * 16777619u; }
+    void ajouter(int8_t valeur) { ajouter((uint8_t)valeur); }
+    void ajouter(uint16_t valeur) { ajouter((uint8_t)valeur); ajouter((uint8_t)(valeur >> 8)); }
+
+    uint32_t valeur() const { return m_valeur; }
+
+private:
+    uint32_t m_valeur;
+};
+
+/**
+ * @brief Chronométrer un traitement et afficher le temps moyen par appel
+ *
+ * @param nom      [In] Nom affiché
+ * @param nbAppels [In] Nombre d'appels de `traitement`, qui reçoit l'indice de l'appel
+ * @param empr     [In] Empreinte des sorties, affichée à côté du temps
+ */
+template<typename Traitement>
+inline void chronometrer(char const * nom, unsigned long nbAppels, Traitement traitement, empreinte const & empr)
+{
+    std::chrono::steady_clock::time_point debut = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < nbAppels; ++i)
+    {
+        traitement(i);
+    }
+    std::chrono::steady_clock::time_point fin = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(fin - debut).count() / nbAppels;
+    printf("%-28s %10lu appels %9.1f ns/appel  empreinte %08X\n", nom, nbAppels, ns, (unsigned)empr.valeur());
+}
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @file banc_emission.cpp
+ * @brief Compare l'émission sur changement de consigne de la télécommande à l'émission à cadence fixe.
+ *
+ * Une trace du joystick (session enregistrée par la télécommande, ou trace synthétique par défaut) est
+ * rejouée milliseconde par milliseconde. Chaque politique lit le joystick à sa propre période et décide
+ * d'émettre ; on mesure le nombre de messages, le temps d'antenne et le délai entre un changement de
+ * consigne et le premier message émis après lui.
+ *
+ * Utilisation :
+ *   banc_emission [session.bin]
+ */
+
+#include <stdio.h>
+#include <vector>
+
+#include <politiqueEmission.h>
+#include <radioMessage.h>
+
+#include "traceManette.h"
+
+#define PERIODE_ECHANTILLON 10   ///< Période de lecture du joystick en émission sur changement (ms)
+#define PERIODE_BATTEMENT   50   ///< Délai maximal entre deux émissions (ms)
+#define SEUIL_EMISSION      3    ///< Écart de consigne déclenchant une émission (%)
+
+/**
+ * @brief Durée d'antenne d'un message et de son acquittement à 1Mbit/s (µs)
+ *
+ * Préambule, adresse de 5 octets, champ de contrôle de 9 bits, charge utile et CRC de 2 octets.
+ */
+#define DUREE_TRAME   (8 * (1 + 5 + sizeof(radioMessage) + 2) + 9)
+#define DUREE_ACQUIT  (8 * (1 + 5 + 2) + 9)
+
+/**
+ * @brief Résultat d'une politique d'émission
+ */
+struct resultat
+{
+    unsigned long nbTrames;       ///< Messages émis
+    unsigned long nbTramesRepos;  ///< Messages émis manche au repos
+    unsigned long dureeRepos;     ///< Durée passée manche au repos (ms)
+    unsigned long nbChangements;  ///< Changements de consigne
+    unsigned long sommeDelais;    ///< Somme des délais entre un changement et le message suivant (ms)
+    unsigned long delaiMax;       ///< Plus long de ces délais (ms)
+};
+
+/**
+ * @brief Rejouer la trace avec une politique
+ *
+ * @param periode   [In] Période de lecture du joystick (ms)
+ * @param politique [In] Politique sur changement, ou nullptr pour émettre à chaque lecture
+ */
+static resultat rejouer(std::vector<etat> const & trace, unsigned long periode, politiqueEmission * politique)
+{
+    resultat r = { 0, 0, 0, 0, 0, 0 };
+    std::vector<unsigned long> enAttente; // Instants des changements pas encore émis
+
+    for (unsigned long t = 0; t < trace.size(); ++t)
+    {
+        if (t > 0 && trace[t] != trace[t - 1]) enAttente.push_back(t);
+        bool repos = !trace[t].gauche && !trace[t].droit && !trace[t].boutons;
+        if (repos) ++r.dureeRepos;
+        if (t % periode) continue;
+
+        radioMessage msg = {};
+        msg.gauche = trace[t].gauche;
+        msg.droit = trace[t].droit;
+        if (politique && !politique->aEmettre(msg, trace[t].boutons, t)) continue;
+        if (politique) politique->emis(msg, trace[t].boutons, t);
+
+        ++r.nbTrames;
+        if (repos) ++r.nbTramesRepos;
+        for (unsigned long debut : enAttente)
+        {
+            unsigned long delai = t - debut;
+            ++r.nbChangements;
+            r.sommeDelais += delai;
+            if (delai > r.delaiMax) r.delaiMax = delai;
+        }
+        enAttente.clear();
+    }
+    return r;
+}
+
+static void afficher(char const * nom, resultat const & r, unsigned long duree)
+{
+    double secondes = duree / 1000.0;
+    double antenne = r.nbTrames * (double)(DUREE_TRAME + DUREE_ACQUIT) / (duree * 1000.0) * 100.0;
+    printf("%-28s %6.1f trames/s (repos %5.1f)  antenne %6.3f %%  delai moy %5.1f ms  max %3lu ms\n",
+           nom, r.nbTrames / secondes, r.dureeRepos ? r.nbTramesRepos * 1000.0 / r.dureeRepos : 0.0, antenne,
+           r.nbChangements ? (double)r.sommeDelais / r.nbChangements : 0.0, r.delaiMax);
+}
+
+int main(int argc, char ** argv)
+{
+    std::vector<etat> trace;
+    if (!tracer(argc > 1 ? argv[1] : nullptr, trace)) return 1;
+
+    printf("%.1f s, %lu changements de consigne\n", trace.size() / 1000.0,
+           rejouer(trace, 1, nullptr).nbChangements);
+
+    politiqueEmission politique(SEUIL_EMISSION, PERIODE_BATTEMENT);
+    afficher("cadence fixe 100 ms", rejouer(trace, 100, nullptr), trace.size());
+    afficher("cadence fixe 10 ms", rejouer(trace, PERIODE_ECHANTILLON, nullptr), trace.size());
+    afficher("sur changement (3 %, 50 ms)", rejouer(trace, PERIODE_ECHANTILLON, &politique), trace.size());
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file banc_executif.cpp
+ * @brief Vérifie la mesure du budget processeur de `executif` sur les tâches du bateau simulées.
+ *
+ * Les tâches du bateau ont des coûts fixes sur l'horloge virtuelle : moteurs à 1kHz, radio à la demande
+ * (une trame toutes les 20ms), boîte noire à la demande (un octet toutes les 3,4ms au plus, jamais dans un
+ * tour où la radio a traité une trame) et entretien à 10Hz. À t = 500ms, l'entretien bloque 9ms, comme un
+ * long rapport sur le port série : les moteurs sautent un créneau.
+ * Le banc affiche le rapport et vérifie exécutions, durées et dépassements, puis la charge sur une fenêtre
+ * d'une minute, bien au-delà des 43s cumulées qui débordaient un calcul en 32 bits.
+ *
+ * Utilisation :
+ *   banc_executif      (rend 1 si une mesure est fausse)
+ */
+
+#include <stdio.h>
+
+#include <executif.h>
+
+#define DUREE_SIMULATION 999000UL  ///< Durée simulée (µs), arrêtée avant les créneaux de t = 1s
+#define COUT_TOUR        10        ///< Coût d'un tour de boucle hors tâches (µs)
+#define COUT_MOTEURS     120       ///< Coût de la tâche des moteurs (µs)
+#define COUT_TRAME       400       ///< Coût du traitement d'une trame radio (µs)
+#define COUT_SCRUTATION  15        ///< Coût d'une scrutation de la radio sans trame (µs)
+#define PERIODE_TRAMES   20000UL   ///< Période des trames de la télécommande (µs)
+#define COUT_BOITE       30        ///< Coût de l'écriture d'un octet de la boîte noire (µs)
+#define ECRITURE_EEPROM  3400      ///< Durée de l'écriture d'un octet en EEPROM (µs)
+#define COUT_ENTRETIEN   200       ///< Coût de l'entretien (µs)
+#define BLOCAGE          9000      ///< Blocage de l'entretien à t = 500ms (µs)
+#define COUT_LONGUE      900       ///< Coût de la tâche de la fenêtre longue, toutes les 1ms (µs)
+#define FENETRE_LONGUE   60000000UL ///< Fenêtre longue (µs)
+
+static unsigned long prochaineTrame = 0;
+static unsigned long eepromLibre = 0;
+static unsigned long nbTours = 0;
+static unsigned long tourTrame = ~0UL;  ///< Dernier tour où la radio a traité une trame
+
+static bool tacheMoteurs()   { delayMicroseconds(COUT_MOTEURS); return true; }
+static bool tacheLongue()    { delayMicroseconds(COUT_LONGUE); return true; }
+
+static bool tacheRadio()
+{
+    if (micros() < prochaineTrame)
+    {
+        delayMicroseconds(COUT_SCRUTATION);
+        return false;
+    }
+    prochaineTrame += PERIODE_TRAMES;
+    tourTrame = nbTours;
+    delayMicroseconds(COUT_TRAME);
+    return true;
+}
+
+static bool tacheBoite()
+{
+    if (tourTrame == nbTours || micros() < eepromLibre) return false;
+    delayMicroseconds(COUT_BOITE);
+    eepromLibre = micros() + ECRITURE_EEPROM;
+    return true;
+}
+
+static bool tacheEntretien()
+{
+    delayMicroseconds(micros() / 100000 == 5 ? COUT_ENTRETIEN + BLOCAGE : COUT_ENTRETIEN);
+    return true;
+}
+
+static void afficherTache(Print & sortie, uint8_t tache)
+{
+    static char const * const NOMS[] = { "moteurs", "radio", "boite", "entret." };
+    sortie.print(NOMS[tache]);
+}
+
+static int erreurs = 0;
+
+static void verifier(char const * quoi, unsigned long mesure, unsigned long attendu)
+{
+    if (mesure == attendu) return;
+    printf("ERREUR : %s = %lu au lieu de %lu\n", quoi, mesure, attendu);
+    ++erreurs;
+}
+
+int main()
+{
+    executif<4> taches;
+    taches.ajouter(tacheMoteurs, 1000);
+    taches.ajouter(tacheRadio, A_LA_DEMANDE);
+    taches.ajouter(tacheBoite, A_LA_DEMANDE);
+    taches.ajouter(tacheEntretien, 100000);
+    taches.demarrer();
+
+    while (micros() < DUREE_SIMULATION)
+    {
+        taches.tourner();
+        delayMicroseconds(COUT_TOUR);
+        ++nbTours;
+    }
+
+    taches.rapport(Serial, afficherTache);
+
+    // Les moteurs ont sauté un créneau pendant le blocage, avant de repartir de sa fin
+    executif<4> const & t = taches;
+    verifier("depassements moteurs", t.depassements(0), 1);
+    verifier("trames traitees", t.executions(1), DUREE_SIMULATION / PERIODE_TRAMES + 1);
+    verifier("entretiens", t.executions(3), 10);
+    verifier("duree moyenne moteurs", t.dureeMoyenne(0), COUT_MOTEURS);
+    verifier("duree max radio", t.dureeMax(1), COUT_TRAME);
+    verifier("duree max entretien", t.dureeMax(3), COUT_ENTRETIEN + BLOCAGE);
+
+    // La boîte noire suit le rythme de l'EEPROM, moins les tours de trame et le blocage
+    unsigned long ecritures = t.executions(2);
+    if (ecritures < 250 || ecritures > DUREE_SIMULATION / (ECRITURE_EEPROM + COUT_BOITE) + 1)
+    {
+        printf("ERREUR : %lu ecritures de la boite noire en 1s\n", ecritures);
+        ++erreurs;
+    }
+
+    unsigned long moteurs = t.executions(0);
+    if (moteurs < 985 || moteurs > 1000)
+    {
+        printf("ERREUR : %lu executions des moteurs en 1s\n", moteurs);
+        ++erreurs;
+    }
+
+    printf("Charge : %u %%\n", taches.charge());
+
+    // Une tâche occupée à 90% pendant une minute : 54s cumulées
+    executif<1> longue;
+    longue.ajouter(tacheLongue, 1000);
+    longue.demarrer();
+    unsigned long debutLongue = micros();
+    while (micros() - debutLongue < FENETRE_LONGUE)
+    {
+        longue.tourner();
+        delayMicroseconds(COUT_TOUR);
+    }
+    printf("Charge sur %lu s : %u %%\n", FENETRE_LONGUE / 1000000, longue.charge());
+    verifier("charge sur une minute", longue.charge(), COUT_LONGUE / 10);
+
+    return erreurs ? 1 : 0;
+}
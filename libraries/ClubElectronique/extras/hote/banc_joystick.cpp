@@ -0,0 +1,45 @@
+/**
+ * @file banc_joystick.cpp
+ * @brief Banc d'essai de `joystickToMotors::convert` sur toutes les positions du joystick.
+ */
+
+#include <joystickToMotors.h>
+
+#include "banc.h"
+
+#define NB_POSITIONS (201ul * 201ul) ///< Positions x et y de -100 à 100
+
+static void mesurer(char const * nom, joystickToMotors::mapping algo)
+{
+    joystickToMotors conversion;
+    conversion.changeMapping(algo);
+
+    empreinte empr;
+    for (int x = -100; x <= 100; ++x)
+    {
+        for (int y = -100; y <= 100; ++y)
+        {
+            int8_t g, d;
+            conversion.convert(x, y, g, d);
+            empr.ajouter(g);
+            empr.ajouter(d);
+        }
+    }
+
+    volatile int8_t puits = 0;
+    chronometrer(nom, 10 * NB_POSITIONS, [&](unsigned long i) {
+        int8_t g, d;
+        conversion.convert((int8_t)(i % 201) - 100, (int8_t)(i / 201 % 201) - 100, g, d);
+        puits = g ^ d;
+    }, empr);
+}
+
+int main()
+{
+    mesurer("convert simple", joystickToMotors::simple);
+    mesurer("convert smooth", joystickToMotors::smooth);
+    mesurer("convert tank", joystickToMotors::tank);
+    mesurer("convert arcade", joystickToMotors::arcade);
+    mesurer("convert precision", joystickToMotors::precision);
+    return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file banc_lissage.cpp
+ * @brief Mesure l'effet de `lisseurConsigne` sur les consignes moteurs du bateau.
+ *
+ * La trace du joystick passe par l'émission de la télécommande (cadence fixe de 100ms ou émission sur
+ * changement), par une liaison qui perd une trame sur N, puis par le bateau : consigne appliquée telle
+ * que reçue, ou lissée toutes les 10ms. On mesure, à la période de lissage, le plus grand saut de
+ * consigne, l'à-coup moyen (variation de la variation) et l'écart moyen à la consigne du joystick.
+ * Avec l'émission sur changement, la rampe de tout l'intervalle entre trames est comparée à une rampe
+ * bornée quand aucune trame ne manque (`rampeSuivie`) : plus courte, elle retarde moins le bateau mais
+ * lisse moins. Le failsafe du bateau n'est pas simulé.
+ *
+ * Utilisation :
+ *   banc_lissage [session.bin]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <lisseurConsigne.h>
+#include <politiqueEmission.h>
+#include <radioMessage.h>
+
+#include "traceManette.h"
+
+#define PERIODE_LISSAGE 10   ///< Période d'application des consignes aux moteurs (ms)
+#define RAMPE_MAX       100  ///< Durée maximale d'une rampe (ms)
+#define PERIODE_ECHANTILLON 10 ///< Période d'échantillonnage du joystick de la télécommande (ms)
+
+/**
+ * @brief Mesures sur les deux moteurs, à la période de lissage
+ */
+struct mesures
+{
+    unsigned long nb;          ///< Nombre de consignes mesurées
+    int           sautMax;     ///< Plus grand saut de consigne entre deux périodes
+    unsigned long sommeACoup;  ///< Somme des |variation de la variation|
+    unsigned long sommeEcart;  ///< Somme des |consigne appliquée - consigne du joystick|
+
+    void ajouter(int consigne, int precedente, int avantDerniere, int joystick)
+    {
+        int saut = abs(consigne - precedente);
+        if (saut > sautMax) sautMax = saut;
+        sommeACoup += abs(consigne - 2 * precedente + avantDerniere);
+        sommeEcart += abs(consigne - joystick);
+        ++nb;
+    }
+};
+
+/**
+ * @brief Rejouer la trace à travers la télécommande, la liaison et le bateau
+ *
+ * @param politique        [In] Émission sur changement, ou nullptr pour la cadence fixe de 100ms
+ * @param perte            [In] Une trame sur `perte` est perdue (0 : aucune)
+ * @param lissage          [In] Consigne lissée, ou appliquée telle que reçue
+ * @param rampeSuivie      [In] Durée maximale d'une rampe quand aucune trame ne manque (ms)
+ * @param extrapolationMax [In] Prolongation maximale d'une rampe (ms)
+ */
+static mesures rejouer(std::vector<etat> const & trace, politiqueEmission * politique, unsigned perte,
+                       bool lissage, uint16_t rampeSuivie, uint16_t extrapolationMax)
+{
+    mesures m = { 0, 0, 0, 0 };
+    lisseurConsigne lisseur(PERIODE_LISSAGE, RAMPE_MAX, rampeSuivie, extrapolationMax);
+    unsigned long periode = politique ? PERIODE_LISSAGE : 100;
+    uint8_t seq = 0;
+    unsigned long nbEmises = 0;
+    int8_t recue[2] = { 0, 0 };
+    int historique[2][2] = { { 0, 0 }, { 0, 0 } };
+
+    for (unsigned long t = 0; t < trace.size(); ++t)
+    {
+        if (t % periode == 0)
+        {
+            radioMessage msg = {};
+            msg.gauche = trace[t].gauche;
+            msg.droit = trace[t].droit;
+            if (!politique || politique->aEmettre(msg, trace[t].boutons, t))
+            {
+                if (politique) politique->emis(msg, trace[t].boutons, t);
+                ++seq;
+                if (!perte || ++nbEmises % perte)
+                {
+                    recue[0] = msg.gauche;
+                    recue[1] = msg.droit;
+                    lisseur.recevoir(msg.gauche, msg.droit, seq, t);
+                }
+            }
+        }
+
+        if (t % PERIODE_LISSAGE == 0)
+        {
+            lisseur.avancer(t);
+            int consigne[2] = { lissage ? lisseur.gauche() : recue[0], lissage ? lisseur.droit() : recue[1] };
+            int joystick[2] = { trace[t].gauche, trace[t].droit };
+            for (uint8_t moteur = 0; moteur < 2; ++moteur)
+            {
+                m.ajouter(consigne[moteur], historique[moteur][0], historique[moteur][1], joystick[moteur]);
+                historique[moteur][1] = historique[moteur][0];
+                historique[moteur][0] = consigne[moteur];
+            }
+        }
+    }
+    return m;
+}
+
+static void afficher(char const * nom, mesures const & m)
+{
+    printf("%-44s saut max %3d  a-coup moy %5.2f  ecart moy %5.2f\n",
+           nom, m.sautMax, (double)m.sommeACoup / m.nb, (double)m.sommeEcart / m.nb);
+}
+
+int main(int argc, char ** argv)
+{
+    std::vector<etat> trace;
+    if (!tracer(argc > 1 ? argv[1] : nullptr, trace)) return 1;
+
+    printf("%.1f s, mesures toutes les %d ms\n", trace.size() / 1000.0, PERIODE_LISSAGE);
+
+    for (unsigned perte : { 0u, 10u })
+    {
+        char nom[64];
+        snprintf(nom, sizeof(nom), "cadence 100 ms, perte 1/%u", perte);
+        if (!perte) snprintf(nom, sizeof(nom), "cadence 100 ms, sans perte");
+        printf("%s\n", nom);
+        afficher("  consigne recue", rejouer(trace, nullptr, perte, false, RAMPE_MAX, 0));
+        afficher("  lissee, maintien", rejouer(trace, nullptr, perte, true, RAMPE_MAX, 0));
+        afficher("  lissee, extrapolation 50 ms", rejouer(trace, nullptr, perte, true, RAMPE_MAX, 50));
+
+        politiqueEmission politique(3, 50);
+        printf("%s\n", perte ? "sur changement (3 %, 50 ms), perte 1/10" : "sur changement (3 %, 50 ms), sans perte");
+        afficher("  consigne recue", rejouer(trace, &politique, perte, false, RAMPE_MAX, 0));
+        politique = politiqueEmission(3, 50);
+        afficher("  lissee, rampe de tout l'intervalle", rejouer(trace, &politique, perte, true, RAMPE_MAX, 0));
+        politique = politiqueEmission(3, 50);
+        afficher("  lissee, rampe bornee a 20 ms", rejouer(trace, &politique, perte, true, 20, 0));
+        politique = politiqueEmission(3, 50);
+        afficher("  lissee, rampe bornee a 10 ms (echantillon)", rejouer(trace, &politique, perte, true, PERIODE_ECHANTILLON, 0));
+    }
+    return 0;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file banc_mixeur.cpp
+ * @brief Vérifie les sorties de `mixeur` contre des vecteurs de référence, préréglage par préréglage.
+ *
+ * Chaque cas configure le mixeur comme le ferait le récepteur de l'avion (empennage classique, elevons avec
+ * ou sans différentiel, empennage en V, ailerons différentiels, compensation des gaz sur la profondeur,
+ * trims et fins de course, expo) puis calcule les sorties de quelques trames : neutre, butées, positions
+ * intermédiaires. Les sorties attendues ont été calculées à part, à partir des formules documentées dans
+ * `mixeur.h` (poids en 1/256 tronqués, expo tabulée en 17 points et interpolée, trim puis fins de course).
+ * Les canaux auxiliaires restent au neutre.
+ *
+ * Utilisation :
+ *   banc_mixeur      (rend 1 si une sortie diffère de sa référence)
+ */
+
+#include <stdio.h>
+
+#include <mixeur.h>
+
+#include "banc.h"
+
+/**
+ * @brief Une trame : les quatre premiers canaux reçus et les sorties attendues
+ */
+struct vecteur
+{
+    uint16_t canaux[4];
+    uint16_t attendu[NB_SORTIES];
+};
+
+/**
+ * @brief Un cas : la configuration du mixeur et ses trames de référence
+ */
+struct cas
+{
+    char const * nom;
+    void (*configurer)(mixeur & mix);
+    vecteur const * vecteurs;
+    uint8_t nbVecteurs;
+};
+
+// Trames communes à tous les cas : neutre, butées opposées, positions intermédiaires
+#define TRAMES_COMMUNES(a, b, c, d, e, f) \
+    { { 1024, 1024, 1024, 1024 }, a }, \
+    { { 2047,    0, 1024, 1536 }, b }, \
+    { {    0, 2047,    0,  512 }, c }, \
+    { { 1536, 1300, 2047,  700 }, d }, \
+    { { 1100,  900, 1500, 1024 }, e }, \
+    { {  600, 1800,  300, 2000 }, f }
+
+#define S(p, d, g, a) { p, d, g, a }
+
+static vecteur const CLASSIQUE[] = {
+    TRAMES_COMMUNES(S(1024, 1024, 1024, 1024), S(2047,    1, 1024, 1536), S(   1, 2047,    1,  512),
+                    S(1536, 1300, 2047,  700), S(1100,  900, 1500, 1024), S( 600, 1800,  300, 2000))
+};
+
+static vecteur const ELEVONS[] = {
+    TRAMES_COMMUNES(S(1024, 1024, 1024, 1024), S(2047, 1535, 1024, 1024), S(   1,  512,    1, 1024),
+                    S(1212, 1860, 2047, 1024), S(1100, 1100, 1500, 1024), S(1576,    1,  300, 1024))
+};
+
+// Le différentiel réduit le débattement vers le bas de l'elevon qui descend, pas celui qui monte
+static vecteur const ELEVONS_DIFFERENTIEL[] = {
+    TRAMES_COMMUNES(S(1024, 1024, 1024, 1024), S(2047, 1689, 1024, 1024), S(   1,  512,    1, 1024),
+                    S(1309, 1860, 2047, 1024), S(1100, 1100, 1500, 1024), S(1576,    1,  300, 1024)),
+    { { 1024, 1024, 1024, 2047 }, S(2047,  308, 1024, 1024) },
+    { { 1024, 1024, 1024,    0 }, S( 308, 2047, 1024, 1024) }
+};
+
+static vecteur const VTAIL[] = {
+    TRAMES_COMMUNES(S(1024, 1024, 1024, 1024), S(1023, 2047, 1024, 1536), S(1023,    1,    1,  512),
+                    S(1812, 1260, 2047,  700), S( 976, 1224, 1500, 1024), S(1376,    1,  300, 2000))
+};
+
+static vecteur const AILERONS_DIFFERENTIELS[] = {
+    TRAMES_COMMUNES(S(1024, 1024, 1024, 1024), S(2047,    1, 1024, 1536), S(   1, 2047,    1,  768),
+                    S(1536, 1300, 2047,  862), S(1100,  900, 1500, 1024), S( 600, 1800,  300, 2000))
+};
+
+// Gaz comptés depuis le ralenti : la compensation agit déjà à mi-gaz
+static vecteur const GAZ_PROFONDEUR[] = {
+    TRAMES_COMMUNES(S( 974, 1024, 1024, 1024), S(1997,    1, 1024, 1536), S(   1, 2047,    1,  512),
+                    S(1436, 1300, 2047,  700), S(1026,  900, 1500, 1024), S( 585, 1800,  300, 2000))
+};
+
+static vecteur const TRIMS_FINS_DE_COURSE[] = {
+    TRAMES_COMMUNES(S(1124, 1024,  974,  944), S(2047,  724,  974, 1224), S( 100, 1524,    1,  824),
+                    S(1636, 1300, 1997,  824), S(1200,  900, 1450,  944), S( 700, 1524,  250, 1224))
+};
+
+// Points de la table (1024 + 64) et entre deux points, des deux côtés du neutre
+static vecteur const EXPO[] = {
+    TRAMES_COMMUNES(S(1024, 1024, 1024, 1024), S(2046,    1, 1024, 1420), S(   1, 2045,    1,  628),
+                    S(1420, 1044, 2047,  788), S(1076, 1023, 1500, 1024), S( 706, 1470,  300, 1973)),
+    { { 1088,  924, 1024, 2024 }, S(1068, 1023, 1024, 2010) },
+    { {  511, 1801, 1024,    1 }, S( 628, 1472, 1024,    2) }
+};
+
+static void classique(mixeur & mix)             { mix.configurerClassique(); }
+static void elevons(mixeur & mix)               { mix.configurerElevons(); }
+static void elevonsDifferentiel(mixeur & mix)   { mix.configurerElevons(30); }
+static void vTail(mixeur & mix)                 { mix.configurerVTail(); }
+static void aileronsDifferentiels(mixeur & mix) { mix.configurerClassique(); mix.configurerAilerons(50); }
+static void gazProfondeur(mixeur & mix)         { mix.configurerClassique(); mix.configurerGazProfondeur(-10); }
+
+static void trimsFinsDeCourse(mixeur & mix)
+{
+    mix.configurerClassique();
+    mix.setTrim(SORTIE_PROFONDEUR, 100);
+    mix.setTrim(SORTIE_GAZ, -50);
+    mix.setFinsDeCourse(SORTIE_DIRECTION, -300, 500);
+    mix.setTrim(SORTIE_AILERONS, -80);
+    mix.setFinsDeCourse(SORTIE_AILERONS, -200, 200);
+}
+
+static void expo(mixeur & mix)
+{
+    mix.configurerClassique();
+    mix.setExpo(CANAL_PROFONDEUR, 30);
+    mix.setExpo(CANAL_DIRECTION, 100);
+    mix.setExpo(CANAL_AILERONS, 30);
+}
+
+#define CAS(nom, configurer, vecteurs) { nom, configurer, vecteurs, sizeof(vecteurs) / sizeof(vecteurs[0]) }
+
+static cas const CAS_MIXEUR[] = {
+    CAS("classique",                 classique,             CLASSIQUE),
+    CAS("elevons",                   elevons,               ELEVONS),
+    CAS("elevons differentiel 30",   elevonsDifferentiel,   ELEVONS_DIFFERENTIEL),
+    CAS("V-tail",                    vTail,                 VTAIL),
+    CAS("ailerons differentiels 50", aileronsDifferentiels, AILERONS_DIFFERENTIELS),
+    CAS("gaz vers profondeur -10",   gazProfondeur,         GAZ_PROFONDEUR),
+    CAS("trims et fins de course",   trimsFinsDeCourse,     TRIMS_FINS_DE_COURSE),
+    CAS("expo 30 / 100",             expo,                  EXPO)
+};
+
+int main()
+{
+    unsigned nbEcarts = 0;
+    unsigned nbTrames = 0;
+
+    for (cas const & c : CAS_MIXEUR)
+    {
+        // Un seul mixeur pour tous les cas : chaque préréglage doit repartir d'un état propre
+        static mixeur mix;
+        mix.effacer();
+        c.configurer(mix);
+
+        for (uint8_t v = 0; v < c.nbVecteurs; ++v)
+        {
+            vecteur const & ref = c.vecteurs[v];
+            uint16_t canaux[NB_CANAUX];
+            uint16_t sorties[NB_SORTIES];
+
+            for (uint8_t i = 0; i < NB_CANAUX; ++i) canaux[i] = i < 4 ? ref.canaux[i] : CANAL_CENTRE;
+            mix.calculer(canaux, sorties);
+            ++nbTrames;
+
+            for (uint8_t s = 0; s < NB_SORTIES; ++s)
+            {
+                if (sorties[s] == ref.attendu[s]) continue;
+                printf("ECART %s, canaux (%u, %u, %u, %u), sortie %u : %u au lieu de %u\n", c.nom,
+                       ref.canaux[0], ref.canaux[1], ref.canaux[2], ref.canaux[3], s, sorties[s], ref.attendu[s]);
+                ++nbEcarts;
+            }
+        }
+    }
+
+    // La table de règles est bornée : une règle de trop est refusée
+    mixeur plein;
+    for (uint8_t i = 0; i < NB_REGLES; ++i) plein.ajouterRegle(CANAL_GAZ, SORTIE_GAZ, 10);
+    if (plein.ajouterRegle(CANAL_GAZ, SORTIE_GAZ, 10))
+    {
+        printf("ECART regle acceptee au-dela de NB_REGLES\n");
+        ++nbEcarts;
+    }
+
+    // Temps de calcul d'une trame, sur la configuration du récepteur
+    mixeur recepteur;
+    recepteur.configurerClassique();
+    recepteur.setExpo(CANAL_PROFONDEUR, 30);
+    recepteur.setExpo(CANAL_DIRECTION, 30);
+    recepteur.setExpo(CANAL_AILERONS, 30);
+
+    empreinte empr;
+    uint16_t canaux[NB_CANAUX] = { 0 };
+    uint16_t sorties[NB_SORTIES];
+    for (uint16_t x = 0; x <= CANAL_MAX; ++x)
+    {
+        for (uint8_t i = 0; i < 4; ++i) canaux[i] = (x + i * 512) & CANAL_MAX;
+        recepteur.calculer(canaux, sorties);
+        for (uint16_t s : sorties) empr.ajouter(s);
+    }
+
+    printf("%u trames de reference, %u ecart(s)\n", nbTrames, nbEcarts);
+    uint16_t volatile puits = 0;
+    chronometrer("mixeur.calculer", 100 * (CANAL_MAX + 1), [&](unsigned long i) {
+        for (uint8_t c = 0; c < 4; ++c) canaux[c] = (i + c * 512) & CANAL_MAX;
+        recepteur.calculer(canaux, sorties);
+        puits = sorties[i & 3];
+    }, empr);
+
+    return nbEcarts ? 1 : 0;
+}
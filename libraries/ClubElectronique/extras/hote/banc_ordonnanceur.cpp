@@ -0,0 +1,205 @@
+/**
+ * @file banc_ordonnanceur.cpp
+ * @brief Vérifie l'ordonnanceur et les séquences du petit robot (`PetitRobot/ordonnanceur.h`) sur l'horloge virtuelle.
+ *
+ * Le banc reprend les tâches du robot : détection toutes les 30ms, déroulement de la réaction
+ * toutes les 10ms, et la réaction elle-même (alarme 1000ms, pause 150ms, bras en haut 300ms, bras au milieu
+ * 1000ms, bras en bas). Les actions notent l'instant où elles s'exécutent ; le banc vérifie leur ordre et
+ * leur instant :
+ * - boucle rapide (1ms) : chaque étape tombe exactement à son instant prévu ;
+ * - boucle lente (7ms de travail par tour) : chaque étape est en retard d'au plus un tour plus une période
+ *   de la tâche, sans que le retard ne s'accumule d'une étape à l'autre ;
+ * - interruption : plus aucune action après `interrompre()`, et la réaction suivante repart de l'alarme.
+ *
+ * Utilisation :
+ *   banc_ordonnanceur      (rend 1 si une étape manque, est en trop ou tombe hors de sa fenêtre)
+ */
+
+#include <stdio.h>
+
+#include <ordonnanceur.h>
+
+#define PERIODE_DETECTION    30   ///< Période de la tâche de détection (ms), SONAR_PERIODE du robot
+#define PERIODE_COMPORTEMENT 10   ///< Période de la tâche de déroulement de la réaction (ms)
+#define DISTANCE_SEUIL       20   ///< Distance en dessous de laquelle le robot réagit (cm)
+#define NB_NOTES_MAX         32   ///< Taille du journal des actions
+
+/**
+ * @brief Actions de la réaction du robot, dans l'ordre
+ */
+enum
+{
+    ALARME = 0,
+    FIN_ALARME,
+    BRAS_HAUT,
+    BRAS_MILIEU,
+    BRAS_BAS,
+    NB_ACTIONS
+};
+
+static char const * const NOMS[NB_ACTIONS] = { "alarme", "fin alarme", "bras haut", "bras milieu", "bras bas" };
+
+// Durée de chaque étape, comme dans robot_agos.ino
+static uint16_t const DUREES[NB_ACTIONS] = { 1000, 150, 300, 1000, 0 };
+
+static struct
+{
+    uint8_t       action;
+    unsigned long instant;
+} s_journal[NB_NOTES_MAX];
+static uint8_t s_nbNotes = 0;
+
+static void noter(uint8_t action)
+{
+    if (s_nbNotes >= NB_NOTES_MAX) return;
+    s_journal[s_nbNotes].action = action;
+    s_journal[s_nbNotes].instant = millis();
+    ++s_nbNotes;
+}
+
+static void alarme()     { noter(ALARME); }
+static void finAlarme()  { noter(FIN_ALARME); }
+static void brasHaut()   { noter(BRAS_HAUT); }
+static void brasMilieu() { noter(BRAS_MILIEU); }
+static void brasBas()    { noter(BRAS_BAS); }
+
+static etape const ETAPES_REACTION[] = {
+    { alarme,     DUREES[ALARME] },
+    { finAlarme,  DUREES[FIN_ALARME] },
+    { brasHaut,   DUREES[BRAS_HAUT] },
+    { brasMilieu, DUREES[BRAS_MILIEU] },
+    { brasBas,    DUREES[BRAS_BAS] },
+};
+static sequence s_reaction(ETAPES_REACTION, sizeof(ETAPES_REACTION) / sizeof(ETAPES_REACTION[0]));
+
+static unsigned int s_distance = 100;
+
+static void detection(unsigned long maintenant)
+{
+    if (s_reaction.enCours()) return;
+    if (s_distance < DISTANCE_SEUIL) s_reaction.lancer(maintenant);
+}
+
+static void comportement(unsigned long maintenant)
+{
+    s_reaction.avancer(maintenant);
+}
+
+static int erreurs = 0;
+
+/**
+ * @brief Faire tourner la boucle du robot jusqu'à un instant, avec un coût fixe par tour
+ */
+static void tourner(ordonnanceur & taches, unsigned long jusqua, unsigned long coutTour)
+{
+    while (millis() < jusqua)
+    {
+        taches.executer(millis());
+        delay(coutTour);
+    }
+}
+
+/**
+ * @brief Vérifier qu'une réaction complète est notée à partir de la note `premiere`
+ *
+ * @param cas       [In] Nom du cas
+ * @param premiere  [In] Indice de l'alarme dans le journal
+ * @param lancement [In] Instant attendu de l'alarme (ms)
+ * @param retard    [In] Retard toléré de chaque étape sur son instant prévu (ms)
+ */
+static void verifierReaction(char const * cas, uint8_t premiere, unsigned long lancement, unsigned long retard)
+{
+    unsigned long prevu = lancement;
+
+    for (uint8_t action = ALARME; action < NB_ACTIONS; ++action)
+    {
+        uint8_t note = premiere + action;
+        if (note >= s_nbNotes || s_journal[note].action != action)
+        {
+            printf("ERREUR %s : %s manque\n", cas, NOMS[action]);
+            ++erreurs;
+            return;
+        }
+
+        unsigned long instant = s_journal[note].instant;
+        printf("  %-12s prevu %5lu ms, execute %5lu ms\n", NOMS[action], prevu, instant);
+        if (instant < prevu || instant > prevu + retard)
+        {
+            printf("ERREUR %s : %s a %lu ms au lieu de [%lu, %lu]\n", cas, NOMS[action], instant, prevu, prevu + retard);
+            ++erreurs;
+        }
+
+        // Les étapes s'enchaînent depuis leur fin prévue : le retard d'une étape ne décale pas la suivante
+        prevu += DUREES[action];
+    }
+}
+
+static void verifierNbNotes(char const * cas, uint8_t attendu)
+{
+    if (s_nbNotes == attendu) return;
+    printf("ERREUR %s : %u action(s) au lieu de %u\n", cas, s_nbNotes, attendu);
+    ++erreurs;
+}
+
+/**
+ * @brief Recommencer sur une horloge à zéro, obstacle loin
+ */
+static void recommencer(ordonnanceur & taches)
+{
+    hal::tempsUs = 0;
+    s_nbNotes = 0;
+    s_distance = 100;
+    s_reaction.interrompre();
+    taches = ordonnanceur();
+    taches.ajouter(detection, PERIODE_DETECTION, millis());
+    taches.ajouter(comportement, PERIODE_COMPORTEMENT, millis());
+}
+
+int main()
+{
+    ordonnanceur taches;
+
+    // Boucle rapide : obstacle à t = 95ms, vu par la détection de t = 120ms
+    puts("Boucle rapide");
+    recommencer(taches);
+    tourner(taches, 95, 1);
+    s_distance = 10;
+    tourner(taches, 2600, 1);
+    verifierReaction("boucle rapide", 0, 120, 0);
+
+    // La réaction finie, la détection suivante (t = 2580ms) relance l'alarme si l'obstacle est toujours là
+    verifierNbNotes("boucle rapide", NB_ACTIONS + 1);
+    if (s_nbNotes > NB_ACTIONS && s_journal[NB_ACTIONS].instant != 2580)
+    {
+        printf("ERREUR boucle rapide : relance a %lu ms au lieu de 2580\n", s_journal[NB_ACTIONS].instant);
+        ++erreurs;
+    }
+
+    // Boucle lente : l'alarme et les étapes sont en retard, mais jamais de plus d'un tour et d'une période
+    puts("Boucle lente (7 ms par tour)");
+    recommencer(taches);
+    s_distance = 10;
+    tourner(taches, 2500, 7);
+    verifierReaction("boucle lente", 0, 0, 7 + PERIODE_COMPORTEMENT);
+
+    // Interruption après le bras en haut : plus rien jusqu'à la fin prévue, puis une nouvelle réaction complète
+    puts("Interruption");
+    recommencer(taches);
+    s_distance = 10;
+    tourner(taches, 1280, 1);
+    s_reaction.interrompre();
+    s_distance = 100;
+    tourner(taches, 3000, 1);
+    verifierNbNotes("interruption", BRAS_HAUT + 1);
+    if (s_reaction.enCours())
+    {
+        puts("ERREUR interruption : sequence toujours en cours");
+        ++erreurs;
+    }
+    s_distance = 10;
+    tourner(taches, 5455, 1);
+    verifierReaction("relance apres interruption", BRAS_HAUT + 1, 3000, 0);
+
+    puts(erreurs ? "ECHEC" : "OK");
+    return erreurs ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+/**
+ * @file banc_passerelle.cpp
+ * @brief Banc d'essai de la passerelle série sans matériel, à travers un pseudo-terminal.
+ *
+ * Un fil d'exécution joue la télécommande : il lit le côté maître du pseudo-terminal avec la classe
+ * `passerelle` de la bibliothèque, émet à chaque période vers une radio simulée qui acquitte toujours,
+ * et renvoie la télémétrie. Le programme principal utilise `clientPasserelle` sur le côté esclave comme le
+ * ferait un script de pilotage. Le banc mesure le débit des commandes et le délai entre l'envoi d'une
+ * commande et la télémétrie annonçant son émission.
+ *
+ * Les deux horloges démarrent ensemble : sans précaution, chaque émission suivrait de peu une commande et
+ * le délai mesuré serait nul. Chaque émission est donc décalée d'une gigue tirée entre 0 et `--gigue` ms
+ * (la cadence des commandes par défaut), ce qui balaie toutes les phases entre les deux horloges ; le banc
+ * affiche le délai moyen et le pire cas.
+ *
+ * Avant la mesure, le banc vérifie que les trames COBS tronquées ou trop longues sont comptées comme
+ * rejetées, contrairement aux délimiteurs répétés.
+ *
+ * Utilisation : banc_passerelle [--periode ms] [--cadence ms] [--gigue ms] [--duree s]
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <random>
+#include <thread>
+
+#include "clientPasserelle.h"
+
+typedef std::chrono::steady_clock horloge;
+
+static unsigned long msDepuis(horloge::time_point debut)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(horloge::now() - debut).count();
+}
+
+/**
+ * @brief Port série de la télécommande simulée, sur un descripteur de fichier
+ */
+class portFd
+{
+public:
+    explicit portFd(int fd) : m_fd(fd), m_nbOctets(0), m_position(0) {}
+
+    int available()
+    {
+        if (m_position == m_nbOctets)
+        {
+            ssize_t lus = ::read(m_fd, m_tampon, sizeof(m_tampon));
+            m_nbOctets = lus > 0 ? lus : 0;
+            m_position = 0;
+        }
+        return m_nbOctets - m_position;
+    }
+    int read() { return available() ? m_tampon[m_position++] : -1; }
+    size_t write(uint8_t const * octets, size_t taille) { return ::write(m_fd, octets, taille); }
+
+private:
+    int     m_fd;
+    uint8_t m_tampon[64];   ///< Comme le tampon de réception de l'Arduino
+    size_t  m_nbOctets;
+    size_t  m_position;
+};
+
+/**
+ * @brief Port série en mémoire, lu d'un bloc
+ */
+class portMemoire
+{
+public:
+    portMemoire(uint8_t const * octets, size_t taille) : m_octets(octets), m_taille(taille), m_position(0) {}
+
+    int available() { return m_taille - m_position; }
+    int read() { return m_position < m_taille ? m_octets[m_position++] : -1; }
+
+private:
+    uint8_t const * m_octets;
+    size_t          m_taille;
+    size_t          m_position;
+};
+
+/**
+ * @brief Trames invalides au milieu de trames valides : seules les premières sont rejetées
+ * @return Nombre d'erreurs de comptage
+ */
+static int verifierRejets()
+{
+    paquetCommande paquet = { PAQUET_COMMANDE, 1, 10, -10, 0 };
+    uint8_t codee[COBS_TAILLE_CODEE(sizeof(paquet) + 1)];
+    uint8_t taille = encoderPaquet(paquet, codee);
+
+    uint8_t flux[128];
+    size_t n = 0;
+    flux[n++] = 0;                                                // délimiteurs répétés : ignorés
+    flux[n++] = 0;
+    memcpy(flux + n, codee, taille); n += taille;                 // valide
+    flux[n++] = 5; flux[n++] = 1; flux[n++] = 2; flux[n++] = 0;   // bloc tronqué
+    memset(flux + n, 0x11, 40); n += 40; flux[n++] = 0;           // trop longue
+    codee[2] ^= 0x40;
+    memcpy(flux + n, codee, taille); n += taille;                 // CRC faux
+    codee[2] ^= 0x40;
+    memcpy(flux + n, codee, taille); n += taille;                 // valide
+
+    portMemoire port(flux, n);
+    passerelle pc;
+    pc.recevoir(port, 0);
+
+    paquetTelemetrie const & t = pc.telemetrie();
+    printf("Trames de test : recues %u, rejetees %u\n", t.nbRecus, t.nbRejetes);
+    return (t.nbRecus == 2 ? 0 : 1) + (t.nbRejetes == 3 ? 0 : 1);
+}
+
+/**
+ * @brief Télécommande simulée : réception au fil de l'eau, émission cadencée avec une gigue
+ */
+static void telecommande(int fd, unsigned long periode, unsigned long gigue, std::atomic<bool> & arreter)
+{
+    portFd port(fd);
+    passerelle pc;
+    radioMessage msg = {};
+    std::minstd_rand tirage(1);  // Même suite de phases d'une exécution à l'autre
+    std::uniform_int_distribution<unsigned long> dephasage(0, gigue);
+    horloge::time_point debut = horloge::now();
+    unsigned long creneau = periode;
+    unsigned long prochaineEmission = creneau + dephasage(tirage);
+
+    while (!arreter)
+    {
+        long attente = (long)(prochaineEmission - msDepuis(debut));
+        if (attente > 0)
+        {
+            pollfd lecture = { fd, POLLIN, 0 };
+            poll(&lecture, 1, attente);
+            pc.recevoir(port, msDepuis(debut));
+            continue;
+        }
+
+        bool commandePC = pc.commande(msg, msDepuis(debut));
+        pc.compteRendu(port, commandePC, true);
+        creneau += periode;
+        prochaineEmission = creneau + dephasage(tirage);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    unsigned long periode = 100;
+    unsigned long cadence = 20;
+    unsigned long gigue = 0;
+    unsigned long duree = 3;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (!strcmp(argv[i], "--periode")) periode = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--cadence")) cadence = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--gigue")) gigue = strtoul(argv[i + 1], nullptr, 10);
+        else if (!strcmp(argv[i], "--duree")) duree = strtoul(argv[i + 1], nullptr, 10);
+    }
+    if (!gigue) gigue = cadence;
+
+    if (verifierRejets())
+    {
+        puts("ERREUR : comptage des trames rejetees");
+        return 1;
+    }
+
+    int maitre = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maitre < 0 || grantpt(maitre) < 0 || unlockpt(maitre) < 0)
+    {
+        perror("posix_openpt");
+        return 1;
+    }
+    fcntl(maitre, F_SETFL, O_NONBLOCK);
+
+    clientPasserelle client;
+    if (!client.ouvrir(ptsname(maitre)))
+    {
+        printf("Impossible d'ouvrir %s\n", ptsname(maitre));
+        return 1;
+    }
+
+    std::atomic<bool> arreter(false);
+    std::thread simulation(telecommande, maitre, periode, gigue, std::ref(arreter));
+
+    std::map<uint16_t, horloge::time_point> envois;
+    paquetTelemetrie telemetrie = {};
+    uint16_t dernierEmis = 0;
+    double delaiTotal = 0, delaiMin = 1e9, delaiMax = 0;
+    unsigned long nbDelais = 0;
+
+    horloge::time_point debut = horloge::now();
+    horloge::time_point prochainEnvoi = debut;
+    while (horloge::now() - debut < std::chrono::seconds(duree))
+    {
+        if (horloge::now() >= prochainEnvoi)
+        {
+            client.envoyer(50, -50);
+            envois[client.dernierNumero()] = horloge::now();
+            prochainEnvoi += std::chrono::milliseconds(cadence);
+        }
+
+        long attente = std::chrono::duration_cast<std::chrono::milliseconds>(prochainEnvoi - horloge::now()).count();
+        if (client.recevoir(telemetrie, attente > 0 ? attente : 0) && telemetrie.nbEmis && telemetrie.numero != dernierEmis)
+        {
+            dernierEmis = telemetrie.numero;
+            std::map<uint16_t, horloge::time_point>::iterator envoi = envois.find(dernierEmis);
+            if (envoi != envois.end())
+            {
+                double ms = std::chrono::duration<double, std::milli>(horloge::now() - envoi->second).count();
+                delaiTotal += ms;
+                delaiMin = ms < delaiMin ? ms : delaiMin;
+                delaiMax = ms > delaiMax ? ms : delaiMax;
+                ++nbDelais;
+            }
+        }
+    }
+
+    arreter = true;
+    simulation.join();
+    client.recevoir(telemetrie, 0);
+
+    printf("Periode d'emission %lu ms (gigue 0 a %lu ms), une commande toutes les %lu ms pendant %lu s\n",
+           periode, gigue, cadence, duree);
+    printf("Commandes envoyees %u, recues %u, rejetees %u, remplacees %u, emises %u, acquittees %u\n",
+           client.dernierNumero(), telemetrie.nbRecus, telemetrie.nbRejetes, telemetrie.nbRemplaces,
+           telemetrie.nbEmis, telemetrie.nbAcquittes);
+    printf("Debit %.1f commandes/s\n", telemetrie.nbRecus / (double)duree);
+    printf("Delai envoi -> emission sur %lu emissions : moyen %.1f ms, min %.1f ms, pire %.1f ms\n",
+           nbDelais, nbDelais ? delaiTotal / nbDelais : 0.0, nbDelais ? delaiMin : 0.0, delaiMax);
+
+    close(maitre);
+    return telemetrie.nbRejetes ? 1 : 0;
+}
@@ -0,0 +1,367 @@
+/**
+ * @file banc_pilotage.cpp
+ * @brief Banc d'essai et de non-régression de toute la chaîne de pilotage du bateau.
+ *
+ * Toutes les positions (x, y) du joystick passent par `joystickToMotors::convert` (conversion simple et
+ * conversion lisse pour une plage d'angles de seuil), puis par `speedToPwmDirection` et
+ * `computeOverDriveDelay` du pont en H. Les sorties de chaque bloc sont résumées par une empreinte comparée
+ * au fichier de référence : une optimisation doit reproduire exactement les sorties actuelles, y compris
+ * leurs arrondis (la troncature de `(int8_t)gauche * magnitude / 100` par exemple).
+ *
+ * Utilisation :
+ *   banc_pilotage                  compare aux références puis mesure chaque étage
+ *   banc_pilotage --ecrire         réécrit le fichier de référence
+ *   banc_pilotage --detail <bloc>  affiche toutes les sorties d'un bloc ("joystick smooth 45", "moteur 127"...)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <map>
+
+#include <joystickToMotors.h>
+#include <pontH.h>
+
+#include "banc.h"
+
+#ifndef FICHIER_REFERENCE
+#define FICHIER_REFERENCE "reference/pilotage.txt"
+#endif
+
+#define ANGLE_MIN   5  ///< Premier angle de seuil testé (un angle nul divise par zéro)
+#define ANGLE_MAX  85  ///< Dernier angle de seuil testé (90 divise par zéro)
+#define ANGLE_PAS   5
+
+#define NB_REPETITIONS 5 ///< Mesures de chaque entrée pour le pire cas
+
+/**
+ * @brief Pont en H dont les étages internes sont accessibles au banc
+ */
+class pontHBanc : public pontH
+{
+public:
+    pontHBanc() : pontH(5, 4, 6, 7) {}
+
+    using pontH::speedToPwmDirection;
+    using pontH::computeOverDriveDelay;
+
+    /**
+     * @brief Placer le moteur 0 dans un état précédent connu
+     */
+    void etatPrecedent(uint8_t pwm, bool direction)
+    {
+        m_pwmOld[0] = pwm;
+        m_directionOld = direction ? (m_directionOld | 1) : (m_directionOld & ~1);
+    }
+};
+
+/**
+ * @brief Destination des sorties d'un bloc : empreinte ou affichage
+ */
+class sortie
+{
+public:
+    explicit sortie(bool afficher) : m_afficher(afficher) {}
+
+    void ligne(int16_t const * valeurs, uint8_t nb)
+    {
+        for (uint8_t i = 0; i < nb; ++i)
+        {
+            m_empreinte.ajouter((uint16_t)valeurs[i]);
+            if (m_afficher) printf(i ? ",%d" : "%d", valeurs[i]);
+        }
+        if (m_afficher) printf("\n");
+    }
+
+    uint32_t valeur() const { return m_empreinte.valeur(); }
+
+private:
+    bool      m_afficher;
+    empreinte m_empreinte;
+};
+
+/**
+ * @brief Bloc joystick : x, y, g, d pour toutes les positions
+ */
+static void blocJoystick(joystickToMotors::mapping algo, int angle, sortie & s)
+{
+    joystickToMotors conversion;
+    conversion.changeMapping(algo);
+    conversion.setAngleSeuil(angle);
+
+    for (int x = -100; x <= 100; ++x)
+    {
+        for (int y = -100; y <= 100; ++y)
+        {
+            int8_t g, d;
+            conversion.convert(x, y, g, d);
+            int16_t valeurs[] = { (int16_t)x, (int16_t)y, g, d };
+            s.ligne(valeurs, 4);
+        }
+    }
+}
+
+/**
+ * @brief Bloc moteur : pour chaque vitesse, PWM, direction et délai d'overdrive depuis l'arrêt,
+ *        depuis le même sens et depuis le sens inverse
+ */
+static void blocMoteur(uint8_t regimeMinimum, sortie & s)
+{
+    pontHBanc pont;
+    pont.setRegimeMinimum(regimeMinimum);
+
+    for (int v = -100; v <= 100; ++v)
+    {
+        int8_t vitesse = v;
+        uint8_t pwm;
+        bool direction;
+        pont.speedToPwmDirection(0, vitesse, pwm, direction);
+
+        uint8_t delais[3];
+        pont.etatPrecedent(0, direction);
+        pont.computeOverDriveDelay(0, pwm, direction, delais[0]);
+        pont.etatPrecedent(regimeMinimum, direction);
+        pont.computeOverDriveDelay(0, pwm, direction, delais[1]);
+        pont.etatPrecedent(regimeMinimum, !direction);
+        pont.computeOverDriveDelay(0, pwm, direction, delais[2]);
+
+        int16_t valeurs[] = { (int16_t)v, pwm, direction, delais[0], delais[1], delais[2] };
+        s.ligne(valeurs, 6);
+    }
+}
+
+/**
+ * @brief Bloc de référence : un étage et son paramètre
+ */
+typedef struct
+{
+    char nom[32];   ///< Nom du bloc dans le fichier de référence
+    bool moteur;    ///< Bloc moteur (sinon bloc joystick)
+    int  parametre; ///< Angle de seuil (0 pour la conversion simple) ou régime minimum
+} bloc;
+
+/**
+ * @brief Produire les sorties d'un bloc
+ */
+static void produire(bloc const & b, sortie & s)
+{
+    if (b.moteur)           blocMoteur(b.parametre, s);
+    else if (b.parametre)   blocJoystick(joystickToMotors::smooth, b.parametre, s);
+    else                    blocJoystick(joystickToMotors::simple, 45, s);
+}
+
+/**
+ * @brief Enumérer tous les blocs de référence
+ *
+ * La conversion simple ne dépend pas de l'angle de seuil : elle n'a qu'un bloc.
+ *
+ * @param traiter [In] Appelé pour chaque bloc
+ */
+template<typename Traitement>
+static void pourChaqueBloc(Traitement traiter)
+{
+    bloc b = { "joystick simple", false, 0 };
+    traiter(b);
+
+    for (int angle = ANGLE_MIN; angle <= ANGLE_MAX; angle += ANGLE_PAS)
+    {
+        snprintf(b.nom, sizeof(b.nom), "joystick smooth %d", angle);
+        b.parametre = angle;
+        traiter(b);
+    }
+
+    uint8_t const regimes[] = { 1, 64, 127, 200, 255 };
+    b.moteur = true;
+    for (uint8_t regime : regimes)
+    {
+        snprintf(b.nom, sizeof(b.nom), "moteur %d", regime);
+        b.parametre = regime;
+        traiter(b);
+    }
+}
+
+/**
+ * @brief Comparer chaque bloc au fichier de référence
+ *
+ * @return Nombre de blocs différents ou absents
+ */
+static int comparer()
+{
+    std::map<std::string, uint32_t> references;
+
+    FILE * fichier = fopen(FICHIER_REFERENCE, "r");
+    if (!fichier)
+    {
+        printf("Fichier de reference %s introuvable\n", FICHIER_REFERENCE);
+        return 1;
+    }
+    char ligne[80];
+    while (fgets(ligne, sizeof(ligne), fichier))
+    {
+        char * separateur = strrchr(ligne, ' ');
+        if (ligne[0] == '#' || !separateur) continue;
+        *separateur = 0;
+        references[ligne] = strtoul(separateur + 1, nullptr, 16);
+    }
+    fclose(fichier);
+
+    int nbEcarts = 0;
+    pourChaqueBloc([&](bloc const & b) {
+        sortie s(false);
+        produire(b, s);
+        std::map<std::string, uint32_t>::const_iterator reference = references.find(b.nom);
+        if (reference == references.end() || reference->second != s.valeur())
+        {
+            printf("ECART %-22s %08X (reference %s)\n", b.nom, (unsigned)s.valeur(),
+                   reference == references.end() ? "absente" : "differente");
+            ++nbEcarts;
+        }
+    });
+
+    printf("%s : %d bloc(s) different(s)\n", FICHIER_REFERENCE, nbEcarts);
+    return nbEcarts;
+}
+
+/**
+ * @brief Réécrire le fichier de référence avec les sorties actuelles
+ */
+static int ecrire()
+{
+    FILE * fichier = fopen(FICHIER_REFERENCE, "w");
+    if (!fichier)
+    {
+        printf("Impossible d'ecrire %s\n", FICHIER_REFERENCE);
+        return 1;
+    }
+    fprintf(fichier, "# Empreintes de reference de banc_pilotage (regenerer avec banc_pilotage --ecrire)\n");
+    pourChaqueBloc([&](bloc const & b) {
+        sortie s(false);
+        produire(b, s);
+        fprintf(fichier, "%s %08X\n", b.nom, (unsigned)s.valeur());
+    });
+    fclose(fichier);
+    return 0;
+}
+
+/**
+ * @brief Afficher toutes les sorties d'un bloc
+ */
+static int detailler(char const * nom)
+{
+    bool trouve = false;
+    pourChaqueBloc([&](bloc const & b) {
+        if (strcmp(b.nom, nom)) return;
+        sortie s(true);
+        produire(b, s);
+        trouve = true;
+    });
+    if (!trouve) printf("Bloc inconnu : %s\n", nom);
+    return trouve ? 0 : 1;
+}
+
+/**
+ * @brief Mesurer le débit et le pire cas d'un étage
+ *
+ * Le pire cas est mesuré appel par appel : chaque entrée est rejouée NB_REPETITIONS fois et on garde son
+ * meilleur temps, pour que les interruptions du système d'exploitation ne passent pas pour un pire cas.
+ * Il inclut le coût de lecture de l'horloge.
+ *
+ * @param nom     [In] Nom de l'étage
+ * @param nbTours [In] Nombre de passages sur toutes les entrées pour la mesure du débit
+ * @param nbEntrees [In] Nombre d'entrées différentes
+ * @param etage   [In] Traitement d'une entrée, repérée par son indice
+ */
+template<typename Etage>
+static void mesurer(char const * nom, unsigned nbTours, unsigned long nbEntrees, Etage etage)
+{
+    typedef std::chrono::steady_clock horloge;
+
+    double pire = 0;
+    unsigned long entreePire = 0;
+    for (unsigned long i = 0; i < nbEntrees; ++i)
+    {
+        double ns = 1e12;
+        for (uint8_t r = 0; r < NB_REPETITIONS; ++r)
+        {
+            horloge::time_point debut = horloge::now();
+            etage(i);
+            double duree = std::chrono::duration<double, std::nano>(horloge::now() - debut).count();
+            if (duree < ns) ns = duree;
+        }
+        if (ns > pire)
+        {
+            pire = ns;
+            entreePire = i;
+        }
+    }
+
+    horloge::time_point debut = horloge::now();
+    for (unsigned t = 0; t < nbTours; ++t)
+    {
+        for (unsigned long i = 0; i < nbEntrees; ++i) etage(i);
+    }
+    double total = std::chrono::duration<double, std::nano>(horloge::now() - debut).count();
+    double moyen = total / ((double)nbTours * nbEntrees);
+
+    printf("%-24s %8.1f ns/appel %12.0f appels/s  pire %8.1f ns (entree %lu)\n",
+           nom, moyen, 1e9 / moyen, pire, entreePire);
+}
+
+static void mesurerEtages()
+{
+    volatile int8_t puits8 = 0;
+    volatile uint8_t puitsU8 = 0;
+    char nom[32];
+
+    joystickToMotors conversion;
+    conversion.changeMapping(joystickToMotors::simple);
+    mesurer("convert simple", 10, 201ul * 201ul, [&](unsigned long i) {
+        int8_t g, d;
+        conversion.convert((int8_t)(i / 201) - 100, (int8_t)(i % 201) - 100, g, d);
+        puits8 = g ^ d;
+    });
+
+    conversion.changeMapping(joystickToMotors::smooth);
+    for (int angle = 15; angle <= 75; angle += 30)
+    {
+        conversion.setAngleSeuil(angle);
+        snprintf(nom, sizeof(nom), "convert smooth %d", angle);
+        mesurer(nom, 10, 201ul * 201ul, [&](unsigned long i) {
+            int8_t g, d;
+            conversion.convert((int8_t)(i / 201) - 100, (int8_t)(i % 201) - 100, g, d);
+            puits8 = g ^ d;
+        });
+    }
+
+    pontHBanc pont;
+    mesurer("speedToPwmDirection", 10000, 201, [&](unsigned long i) {
+        int8_t vitesse = (int8_t)i - 100;
+        uint8_t pwm;
+        bool direction;
+        pont.speedToPwmDirection(0, vitesse, pwm, direction);
+        puitsU8 = pwm ^ direction;
+    });
+
+    mesurer("computeOverDriveDelay", 10000, 2 * 256, [&](unsigned long i) {
+        uint8_t delai;
+        pont.etatPrecedent(0, i & 1);
+        pont.computeOverDriveDelay(0, i >> 1, i & 1, delai);
+        puitsU8 = delai;
+    });
+
+    mesurer("chaine complete", 10, 201ul * 201ul, [&](unsigned long i) {
+        int8_t g, d;
+        conversion.convert((int8_t)(i / 201) - 100, (int8_t)(i % 201) - 100, g, d);
+        pont.vitesseMoteurs(g, d);
+    });
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc > 1 && !strcmp(argv[1], "--ecrire")) return ecrire();
+    if (argc > 2 && !strcmp(argv[1], "--detail")) return detailler(argv[2]);
+
+    int nbEcarts = comparer();
+    mesurerEtages();
+    return nbEcarts ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file banc_pointFixe.cpp
+ * @brief Vérification exhaustive de `pointFixe.h` contre `map()` et la division, puis mesure des deux.
+ *
+ * Toutes les plages utilisées par la bibliothèque sont parcourues en entier : calibrations du joypad,
+ * angles de seuil de l'algorithme lisse, régimes minimum et délais d'overboost des moteurs. La division
+ * par réciproque est vérifiée pour tous les dividendes jusqu'à 2048 et aux bords de chaque diviseur 16 bits.
+ * Rend 1 si un seul résultat diffère.
+ */
+
+#include <pointFixe.h>
+#include <stdio.h>
+
+#include "banc.h"
+
+static unsigned long s_nbVerifications = 0;
+static unsigned long s_nbEcarts = 0;
+
+static void verifier(bool egal, char const * cas, long a, long b, long x)
+{
+    ++s_nbVerifications;
+    if (egal) return;
+    if (s_nbEcarts++ < 10) printf("ECART %s (%ld, %ld) x=%ld\n", cas, a, b, x);
+}
+
+/**
+ * @brief Division par réciproque : tous les dividendes pour les petits diviseurs, les bords pour les autres
+ */
+static void verifierReciproques()
+{
+    for (uint32_t d = 1; d <= 0xFFFF; ++d)
+    {
+        reciproque r(d);
+        if (d <= 2048)
+        {
+            for (uint32_t n = 0; n <= 0xFFFF; ++n) verifier(diviser(n, r) == n / d, "diviser", d, 0, n);
+        }
+        else
+        {
+            uint32_t multiple = 0xFFFF - 0xFFFF % d;
+            uint32_t bords[] = { 0, d - 1, d, d + 1, multiple - 1, multiple, 0xFFFF };
+            for (uint32_t n : bords) if (n <= 0xFFFF) verifier(diviser(n, r) == n / d, "diviser", d, 0, n);
+        }
+        int32_t signes[] = { -0x7FFF, -(int32_t)d, -1, 1, (int32_t)d, 0x7FFF };
+        for (int32_t n : signes)
+        {
+            verifier(diviserSigne(n, r) == n / (int32_t)d, "diviserSigne", d, 0, n);
+        }
+    }
+}
+
+/**
+ * @brief Échelle contre `map()` sur toutes les entrées d'une plage élargie
+ */
+static void verifierEchelle(char const * cas, long entreeMin, long entreeMax, long sortieMin, long sortieMax, long xMin, long xMax)
+{
+    echelle e(entreeMin, entreeMax, sortieMin, sortieMax);
+    for (long x = xMin; x <= xMax; ++x)
+    {
+        verifier(e(x) == map(x, entreeMin, entreeMax, sortieMin, sortieMax), cas, entreeMin, entreeMax, x);
+    }
+}
+
+int main()
+{
+    verifierReciproques();
+
+    // Joypad : toutes les calibrations, lecture ADC de 0 à 511
+    for (long a = 0; a < 512; ++a)
+    {
+        for (long b = 0; b < 512; ++b)
+        {
+            if (a == b) continue;
+            verifierEchelle("joypad -", a, b, -100, 0, 0, 511);
+            verifierEchelle("joypad +", a, b, 0, 100, 0, 511);
+        }
+    }
+
+    // Algorithme lisse : tous les angles de seuil, angle du joystick de 0 à 180
+    for (long angle = 1; angle < 90; ++angle)
+    {
+        verifierEchelle("lisse 0", 180 - angle, 180, 100, 0, 0, 180);
+        verifierEchelle("lisse 1", 90, 180 - angle, 100, 0, 0, 180);
+        verifierEchelle("lisse 2", angle, 90, 0, 100, 0, 180);
+        verifierEchelle("lisse 3", 0, angle, 0, 100, 0, 180);
+    }
+
+    // Moteurs : table de conversion et délai d'overboost pour tous les régimes et délais
+    for (long regime = 0; regime < 256; ++regime)
+    {
+        verifierEchelle("table", 0, 100, regime, 255, 1, 100);
+        if (regime == 0) continue;
+        for (long delai = 0; delai < 256; ++delai)
+        {
+            verifierEchelle("overboost", regime, 0, 0, delai, 0, 255);
+        }
+    }
+
+    printf("%lu verifications, %lu ecart(s)\n", s_nbVerifications, s_nbEcarts);
+
+    // Mesures sur la plage de l'overboost, la plus large (produits jusqu'à 65025)
+    echelle boost(127, 0, 0, 255);
+    empreinte empr;
+    for (long x = 0; x < 256; ++x) empr.ajouter((uint16_t)boost(x));
+
+    volatile long entree = 0;
+    volatile long puits = 0;
+    chronometrer("map", 100ul * 256, [&](unsigned long i) {
+        puits = map(entree + (long)(i & 0xFF), 127, 0, 0, 255);
+    }, empr);
+    chronometrer("echelle", 100ul * 256, [&](unsigned long i) {
+        puits = boost(entree + (long)(i & 0xFF));
+    }, empr);
+
+    return s_nbEcarts ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file banc_pontH.cpp
+ * @brief Banc d'essai de `pontH::vitesseMoteurs` sur toutes les paires de vitesses.
+ *
+ * Les délais d'overboost font avancer l'horloge virtuelle sans attendre : seul le calcul est mesuré.
+ * Les broches de direction 4 et 7 n'ont pas de PWM : la décroissance reste mixte et l'empreinte ne change pas.
+ *
+ * Vérifie aussi, sur un pont aux broches de direction PWM (3 et 11), les sorties de chaque décroissance et
+ * le frein actif borné dans le temps (rend 1 en cas d'écart).
+ */
+
+#include <pontH.h>
+
+#include "banc.h"
+
+#define PWM_GAUCHE 5
+#define DIR_GAUCHE 4
+#define PWM_DROIT  6
+#define DIR_DROIT  7
+
+#define NB_PAIRES (201ul * 201ul) ///< Vitesses gauche et droite de -100 à 100
+
+#define DIR_PWM_GAUCHE 3
+#define DIR_PWM_DROIT  11
+#define DUREE_FREIN    150
+
+static int erreurs = 0;
+
+/**
+ * @brief Comparer les sorties d'un moteur (PWM sur les deux entrées du pont) aux valeurs attendues
+ */
+static void verifier(char const * quoi, uint8_t pwm, uint8_t direction, int pwmAttendu, int directionAttendue)
+{
+    if (hal::pwm[pwm] == pwmAttendu && hal::pwm[direction] == directionAttendue) return;
+    printf("ERREUR %s : %d/%d au lieu de %d/%d\n", quoi, hal::pwm[pwm], hal::pwm[direction], pwmAttendu, directionAttendue);
+    ++erreurs;
+}
+
+/**
+ * @brief Vérifier les décroissances et le frein actif
+ */
+static void verifierModes()
+{
+    pontH sansPwm(PWM_GAUCHE, DIR_GAUCHE, PWM_DROIT, DIR_DROIT);
+    if (sansPwm.setDecroissance(DECROISSANCE_LENTE) || sansPwm.decroissance() != DECROISSANCE_MIXTE)
+    {
+        printf("ERREUR : decroissance lente acceptee sans PWM sur les broches de direction\n");
+        ++erreurs;
+    }
+
+    pontH pont(PWM_GAUCHE, DIR_PWM_GAUCHE, PWM_DROIT, DIR_PWM_DROIT);
+    pont.setRegimeMinimum(0);
+    pont.setOverBoostDelay(0);
+    uint8_t pwm = pont.regimeMinimum(0, true) + (255 - pont.regimeMinimum(0, true)) / 2; // vitesse 50
+
+    pont.vitesseMoteurs(50, -50);
+    verifier("mixte avant", PWM_GAUCHE, DIR_PWM_GAUCHE, pwm, 0);
+    verifier("mixte arriere", PWM_DROIT, DIR_PWM_DROIT, 255 - pwm, 255);
+
+    pont.setDecroissance(DECROISSANCE_RAPIDE);
+    pont.vitesseMoteurs(50, -50);
+    verifier("rapide avant", PWM_GAUCHE, DIR_PWM_GAUCHE, pwm, 0);
+    verifier("rapide arriere", PWM_DROIT, DIR_PWM_DROIT, 0, pwm);
+
+    pont.setDecroissance(DECROISSANCE_LENTE);
+    pont.vitesseMoteurs(50, -50);
+    verifier("lente avant", PWM_GAUCHE, DIR_PWM_GAUCHE, 255, 255 - pwm);
+    verifier("lente arriere", PWM_DROIT, DIR_PWM_DROIT, 255 - pwm, 255);
+
+    // Sans durée de frein, un moteur qui s'arrête passe en roue libre
+    pont.vitesseMoteurs(0, 0);
+    verifier("roue libre", PWM_GAUCHE, DIR_PWM_GAUCHE, 0, 0);
+
+    // Avec une durée de frein, il est court-circuité puis relâché au bout de la durée, sans bloquer
+    pont.setDureeFrein(DUREE_FREIN);
+    pont.vitesseMoteurs(50, -50);
+    unsigned long debut = micros();
+    pont.vitesseMoteurs(0, -50);
+    if (micros() != debut)
+    {
+        printf("ERREUR : le freinage bloque\n");
+        ++erreurs;
+    }
+    verifier("frein", PWM_GAUCHE, DIR_PWM_GAUCHE, 255, 255);
+    verifier("frein voisin", PWM_DROIT, DIR_PWM_DROIT, 255 - pwm, 255);
+    delay(DUREE_FREIN - 1);
+    pont.relacherFreins();
+    pont.vitesseMoteurs(0, -50);
+    verifier("frein maintenu", PWM_GAUCHE, DIR_PWM_GAUCHE, 255, 255);
+    delay(1);
+    pont.relacherFreins();
+    verifier("frein relache", PWM_GAUCHE, DIR_PWM_GAUCHE, 0, 0);
+
+    // Une consigne pendant le freinage le libère
+    pont.vitesseMoteurs(50, 0);
+    pont.vitesseMoteurs(0, 0);
+    pont.vitesseMoteurs(50, 0);
+    verifier("relance", PWM_GAUCHE, DIR_PWM_GAUCHE, 255, 255 - pwm);
+
+    // Freinage du failsafe, même moteurs à l'arrêt
+    pont.freinerMoteurs(DUREE_FREIN);
+    verifier("failsafe gauche", PWM_GAUCHE, DIR_PWM_GAUCHE, 255, 255);
+    verifier("failsafe droit", PWM_DROIT, DIR_PWM_DROIT, 255, 255);
+    delay(DUREE_FREIN);
+    pont.relacherFreins();
+    verifier("failsafe relache", PWM_DROIT, DIR_PWM_DROIT, 0, 0);
+}
+
+int main()
+{
+    pontH pont(PWM_GAUCHE, DIR_GAUCHE, PWM_DROIT, DIR_DROIT);
+
+    empreinte empr;
+    for (int gauche = -100; gauche <= 100; ++gauche)
+    {
+        for (int droit = -100; droit <= 100; ++droit)
+        {
+            unsigned long debut = micros();
+            pont.vitesseMoteurs(gauche, droit);
+            empr.ajouter((uint8_t)hal::pwm[PWM_GAUCHE]);
+            empr.ajouter(hal::niveau[DIR_GAUCHE]);
+            empr.ajouter((uint8_t)hal::pwm[PWM_DROIT]);
+            empr.ajouter(hal::niveau[DIR_DROIT]);
+            empr.ajouter((uint16_t)((micros() - debut) / 1000));
+        }
+    }
+
+    chronometrer("vitesseMoteurs", 10 * NB_PAIRES, [&](unsigned long i) {
+        pont.vitesseMoteurs((int8_t)(i % 201) - 100, (int8_t)(i / 201 % 201) - 100);
+    }, empr);
+
+    verifierModes();
+    return erreurs ? 1 : 0;
+}
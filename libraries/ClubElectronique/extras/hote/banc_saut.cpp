@@ -0,0 +1,136 @@
+/**
+ * @file banc_saut.cpp
+ * @brief Compare le canal fixe et le saut de fréquence (`sautFrequence`) sur une liaison radio simulée.
+ *
+ * La télécommande émet une trame toutes les 10ms pendant 120s, à travers un milieu brouillé par un
+ * Wi-Fi (canaux 26 à 48) et une autre radio du club sur le canal par défaut des nRF24L01 (76), tous deux
+ * par rafales, par un bruit permanent sur les canaux 60 à 63 et par 2% de pertes de fond. La liaison est
+ * coupée 2s à t = 60s. L'horloge du bateau avance de 0,3% sur celle de la télécommande.
+ *
+ * Pour chaque mode : trames reçues, failsafes (plus de 100ms sans trame, hors coupure), plus long trou
+ * hors coupure, durée avant la première trame reçue, reprise après la coupure et liste noire finale.
+ *
+ * Utilisation :
+ *   banc_saut
+ */
+
+#include <stdio.h>
+
+#include <sautFrequence.h>
+
+#include "radioSimulee.h"
+
+#define DUREE_SIMULATION 120000UL  ///< Durée simulée (ms)
+#define DEBUT_COUPURE    60000UL   ///< Début de la coupure de la liaison (ms)
+#define FIN_COUPURE      62000UL   ///< Fin de la coupure de la liaison (ms)
+#define DELAI_FAILSAFE   100       ///< Failsafe du bateau (ms)
+#define CANAL_FIXE       76        ///< Canal par défaut des nRF24L01
+#define GRAINE           0x4A42    ///< Graine commune aux deux radios
+
+enum mode { canalFixe, saut, sautListeNoire };
+
+struct resultat
+{
+    unsigned long emises;
+    unsigned long recues;
+    unsigned      failsafes;
+    unsigned long trouMax;
+    unsigned long acquisition;
+    unsigned long reprise;
+    uint16_t      listeNoire;
+};
+
+static resultat simuler(mode m)
+{
+    radioSimulee milieu(0.02, 1234);
+    milieu.ajouter({ 26, 48, 0.98, 30, 300, 100, 800 });    // Wi-Fi, canal 6
+    milieu.ajouter({ 75, 77, 0.99, 50, 600, 300, 2000 });   // Autre radio du club
+    milieu.ajouter({ 60, 63, 0.60, 0, 0, 0, 0 });           // Bruit permanent
+
+    sautFrequence telecommande(GRAINE);
+    sautFrequence bateau(GRAINE);
+
+    resultat r = { 0, 0, 0, 0, 0, 0, 0 };
+    bool premiere = true;
+    unsigned long derniere = 0;
+
+    for (unsigned long creneau = 0; creneau * DUREE_CRENEAU_SAUT < DUREE_SIMULATION; ++creneau)
+    {
+        unsigned long t = creneau * DUREE_CRENEAU_SAUT + 1;  // Émission 1ms après le début du créneau
+        unsigned long tBateau = t + t * 3 / 1000 + 437;      // Horloge du bateau : dérive, démarrage décalé
+        uint8_t seq = creneau;
+
+        radioMessage msg = {};
+        bool annonce = m == sautListeNoire && telecommande.preparerAnnonce(msg);
+
+        uint8_t canalEmission = m == canalFixe ? CANAL_FIXE : telecommande.canal(seq);
+        uint8_t canalEcoute = m == canalFixe ? CANAL_FIXE : bateau.canalEcoute(tBateau);
+        uint8_t tentatives = m == canalFixe ? 16 : 4;         // Réémissions par défaut, ou 3 en saut de fréquence
+
+        bool recue = false;
+        bool acquittee = false;
+        bool coupure = t >= DEBUT_COUPURE && t < FIN_COUPURE;
+        for (uint8_t essai = 0; essai < tentatives && !acquittee && !coupure; ++essai)
+        {
+            if (canalEcoute != canalEmission || !milieu.transmettre(canalEmission, t)) continue;
+            recue = true;
+            acquittee = milieu.transmettre(canalEmission, t);
+        }
+        ++r.emises;
+
+        if (recue)
+        {
+            ++r.recues;
+            bateau.recue(seq, tBateau);
+            if (annonce) bateau.appliquerAnnonce(msg);
+
+            if (premiere)
+            {
+                r.acquisition = t;
+                premiere = false;
+            }
+            else if (derniere < DEBUT_COUPURE && t >= FIN_COUPURE)
+            {
+                r.reprise = t - FIN_COUPURE;
+            }
+            else
+            {
+                unsigned long trou = t - derniere;
+                if (trou > DELAI_FAILSAFE) ++r.failsafes;
+                if (trou > r.trouMax) r.trouMax = trou;
+            }
+            derniere = t;
+        }
+
+        if (annonce && acquittee) telecommande.annonceAcquittee(msg);
+        telecommande.emise(seq, acquittee);
+    }
+
+    r.listeNoire = telecommande.listeNoire();
+    if (r.listeNoire != bateau.listeNoire()) printf("ERREUR : listes noires differentes\n");
+    return r;
+}
+
+static void afficher(char const * nom, resultat const & r, sautFrequence const & sequence)
+{
+    printf("%-24s %6.2f %%  %4u  %5lu ms  %5lu ms  %5lu ms  ", nom, 100.0 * r.recues / r.emises, r.failsafes,
+           r.trouMax, r.acquisition, r.reprise);
+    for (uint8_t p = 0; p < NB_CANAUX_SAUT; ++p)
+    {
+        if (r.listeNoire & (1u << p)) printf("%u ", sequence.canal(p));
+    }
+    printf("\n");
+}
+
+int main()
+{
+    sautFrequence sequence(GRAINE);
+    printf("Sequence :");
+    for (uint8_t p = 0; p < NB_CANAUX_SAUT; ++p) printf(" %u", sequence.canal(p));
+    printf("\n\n%-24s %8s  %4s  %8s  %8s  %8s  %s\n", "", "recues", "fs", "trou max", "acquis.", "reprise", "liste noire");
+
+    afficher("canal fixe 76", simuler(canalFixe), sequence);
+    afficher("saut de frequence", simuler(saut), sequence);
+    afficher("saut + liste noire", simuler(sautListeNoire), sequence);
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file banc_trame.cpp
+ * @brief Banc d'essai du codage et du décodage des trames radio.
+ */
+
+#include <radioMessage.h>
+#include <trameCanaux.h>
+
+#include "banc.h"
+
+#define NB_TRAMES 1000000ul
+
+/**
+ * @brief Valeurs de canaux différentes à chaque trame, couvrant toute la plage
+ */
+static void remplir(uint16_t (&canaux)[NB_CANAUX], unsigned long i)
+{
+    for (uint8_t c = 0; c < NB_CANAUX; ++c)
+    {
+        canaux[c] = (i * 37 + c * 523) & CANAL_MAX;
+    }
+}
+
+int main()
+{
+    uint16_t canaux[NB_CANAUX];
+    uint16_t decodes[NB_CANAUX];
+    trameCanaux trame;
+    empreinte emprCodage, emprDecodage, emprMessage;
+    unsigned long nbErreurs = 0;
+
+    for (unsigned long i = 0; i < 4096; ++i)
+    {
+        remplir(canaux, i);
+        encoderTrame(trame, canaux, i);
+        for (uint8_t o = 0; o < sizeof(trame); ++o) emprCodage.ajouter(reinterpret_cast<uint8_t const *>(&trame)[o]);
+
+        if (!decoderTrame(trame, decodes) || memcmp(canaux, decodes, sizeof(canaux))) ++nbErreurs;
+        for (uint8_t c = 0; c < NB_CANAUX; ++c) emprDecodage.ajouter(decodes[c]);
+
+        radioMessage msg = { (char)(i >> 8), (char)i, (char)(i * 7), (char)(i >> 3), 0 };
+        assignCheck(msg);
+        emprMessage.ajouter((uint8_t)msg.check);
+    }
+    if (nbErreurs)
+    {
+        printf("%lu trames mal decodees\n", nbErreurs);
+        return 1;
+    }
+
+    chronometrer("encoderTrame", NB_TRAMES, [&](unsigned long i) {
+        canaux[i & 7] = i & CANAL_MAX;
+        encoderTrame(trame, canaux, i);
+    }, emprCodage);
+
+    chronometrer("decoderTrame", NB_TRAMES, [&](unsigned long i) {
+        trame.seq = i;
+        trame.crc = crc8(reinterpret_cast<uint8_t const *>(&trame), sizeof(trame) - 1);
+        decoderTrame(trame, decodes);
+    }, emprDecodage);
+
+    volatile bool puits = false;
+    chronometrer("messageIsValid", NB_TRAMES, [&](unsigned long i) {
+        radioMessage msg = { (char)(i >> 8), (char)i, (char)(i * 7), (char)(i >> 3), (char)(i >> 16) };
+        puits = messageIsValid(msg);
+    }, emprMessage);
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file clientPasserelle.cpp
+ * @brief Implémentation POSIX du client de la passerelle série.
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "clientPasserelle.h"
+
+/**
+ * @brief Correspondance entre un débit et sa constante termios
+ */
+static speed_t vitesse(unsigned long baud)
+{
+    switch (baud)
+    {
+    case 9600:    return B9600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    case 500000:  return B500000;
+    case 1000000: return B1000000;
+    default:      return B0;
+    }
+}
+
+/**
+ * @brief Ouvrir le port série en mode brut
+ *
+ * @param chemin [In] Chemin du port (/dev/ttyUSB0...)
+ * @param baud   [In] Débit
+ * @return false si le port ne peut pas être ouvert ou configuré
+ */
+bool clientPasserelle::ouvrir(char const * chemin, unsigned long baud)
+{
+    fermer();
+
+    m_fd = open(chemin, O_RDWR | O_NOCTTY);
+    if (m_fd < 0) return false;
+
+    termios config;
+    if (tcgetattr(m_fd, &config) < 0 || vitesse(baud) == B0)
+    {
+        fermer();
+        return false;
+    }
+    cfmakeraw(&config);
+    cfsetispeed(&config, vitesse(baud));
+    cfsetospeed(&config, vitesse(baud));
+    config.c_cc[VMIN] = 0;
+    config.c_cc[VTIME] = 0;
+    if (tcsetattr(m_fd, TCSANOW, &config) < 0)
+    {
+        fermer();
+        return false;
+    }
+    return true;
+}
+
+void clientPasserelle::fermer()
+{
+    if (m_fd >= 0) close(m_fd);
+    m_fd = -1;
+}
+
+/**
+ * @brief Envoyer une commande des moteurs
+ *
+ * Chaque commande reçoit un nouveau numéro, que la télémétrie renvoie une fois la commande émise.
+ *
+ * @return false si l'écriture a échoué
+ */
+bool clientPasserelle::envoyer(int8_t gauche, int8_t droit, uint8_t cmd)
+{
+    paquetCommande paquet;
+    paquet.type = PAQUET_COMMANDE;
+    paquet.numero = ++m_numero;
+    paquet.gauche = gauche;
+    paquet.droit = droit;
+    paquet.cmd = cmd;
+
+    uint8_t codee[COBS_TAILLE_CODEE(sizeof(paquet) + 1)];
+    uint8_t taille = encoderPaquet(paquet, codee);
+    return write(m_fd, codee, taille) == taille;
+}
+
+/**
+ * @brief Attendre un paquet de télémétrie
+ *
+ * @param telemetrie [Out] Paquet reçu
+ * @param delaiMs    [In]  Attente maximale (ms), 0 pour ne lire que ce qui est déjà arrivé
+ * @return true si un paquet valide a été reçu
+ */
+bool clientPasserelle::recevoir(paquetTelemetrie & telemetrie, int delaiMs)
+{
+    pollfd attente = { m_fd, POLLIN, 0 };
+    while (poll(&attente, 1, delaiMs) > 0)
+    {
+        uint8_t octet;
+        if (read(m_fd, &octet, 1) != 1) return false;
+
+        uint8_t taille = m_decodeur.ajouter(octet);
+        if (taille && taille != COBS_INVALIDE && decoderPaquet(m_decodeur.trame(), taille, PAQUET_TELEMETRIE, telemetrie)) return true;
+    }
+    return false;
+}
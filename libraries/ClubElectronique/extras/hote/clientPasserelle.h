@@ -0,0 +1,36 @@
+/**
+ * @file clientPasserelle.h
+ * @brief Client PC de la passerelle série de la télécommande.
+ *
+ * Ouvre le port série de la télécommande compilée avec TELECOMMANDE_PASSERELLE, envoie les commandes des
+ * moteurs et lit les paquets de télémétrie. Les scripts de pilotage automatique et les bancs de test
+ * n'ont besoin que de cette classe.
+ */
+
+#pragma once
+#ifndef CLIENTPASSERELLE_h
+#define CLIENTPASSERELLE_h
+
+#include <passerelleSerie.h>
+
+class clientPasserelle
+{
+public:
+    clientPasserelle() : m_fd(-1), m_numero(0) {}
+    ~clientPasserelle() { fermer(); }
+
+    bool ouvrir(char const * chemin, unsigned long baud = PASSERELLE_BAUD);
+    void fermer();
+
+    bool envoyer(int8_t gauche, int8_t droit, uint8_t cmd = 0);
+    bool recevoir(paquetTelemetrie & telemetrie, int delaiMs);
+
+    uint16_t dernierNumero() const { return m_numero; }
+
+private:
+    int          m_fd;        ///< Descripteur du port série
+    uint16_t     m_numero;    ///< Numéro de la dernière commande envoyée
+    decodeurCobs m_decodeur;  ///< Trames reçues de la télécommande
+};
+
+#endif
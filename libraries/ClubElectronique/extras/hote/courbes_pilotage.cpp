@@ -0,0 +1,179 @@
+/**
+ * @file courbes_pilotage.cpp
+ * @brief Trace et vérifie les courbes de pilotage de `joystickToMotors`.
+ *
+ * Pour chaque algorithme, affiche les consignes gauche et droite à pleine magnitude en fonction de
+ * l'angle, et le gain en fonction de la magnitude, sous forme de graphe texte (ou de CSV). Vérifie que les
+ * tables précalculées passent exactement par les points des courbes intégrées, qu'elles restent dans
+ * -100..100, que les gains sont croissants, et que `convert` donne le même résultat qu'un calcul direct.
+ *
+ * Utilisation :
+ *   courbes_pilotage          (rend 1 si une vérification échoue)
+ *   courbes_pilotage --csv    (angle ou magnitude;algorithme;gauche;droit)
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <joystickToMotors.h>
+
+#define LARGEUR 61 ///< Colonnes du graphe, pour les consignes de -100 à 100
+#define PAS     10 ///< Pas d'angle et de magnitude du graphe
+
+static char const * const NOMS[joystickToMotors::mappinEnumSize] = { "simple", "smooth", "tank", "arcade", "precision" };
+
+static unsigned nbErreurs = 0;
+
+static void erreur(char const * algo, char const * message, int i)
+{
+    printf("ERREUR %s : %s (%d)\n", algo, message, i);
+    ++nbErreurs;
+}
+
+/**
+ * @brief Graphe d'une ligne : 'g' pour la consigne gauche, 'd' pour la droite, '*' si elles se confondent
+ */
+static void tracerLigne(char const * entete, int gauche, int droit)
+{
+    char ligne[LARGEUR + 1];
+    memset(ligne, ' ', LARGEUR);
+    ligne[LARGEUR] = '\0';
+    ligne[LARGEUR / 2] = '|';
+    int colGauche = (gauche + 100) * (LARGEUR - 1) / 200;
+    int colDroit = (droit + 100) * (LARGEUR - 1) / 200;
+    ligne[colGauche] = 'g';
+    ligne[colDroit] = colDroit == colGauche ? '*' : 'd';
+    printf("%s %4d %4d  %s\n", entete, gauche, droit, ligne);
+}
+
+/**
+ * @brief Vérifier qu'une table de direction passe par les points de sa courbe
+ */
+static void verifierPoints(char const * algo, joystickToMotors const & conversion, pointDirection const * points, unsigned nb)
+{
+    for (unsigned i = 0; i < nb; ++i)
+    {
+        if (conversion.consigne(points[i].angle, 0) != points[i].gauche || conversion.consigne(points[i].angle, 1) != points[i].droit)
+        {
+            erreur(algo, "point de la courbe de direction manque", points[i].angle);
+        }
+    }
+}
+
+static void verifierGain(char const * algo, joystickToMotors const & conversion, pointGain const * points, unsigned nb)
+{
+    for (unsigned i = 0; i < nb; ++i)
+    {
+        if (conversion.gain(points[i].magnitude) != points[i].gain) erreur(algo, "point de la courbe de gain manque", points[i].magnitude);
+    }
+    for (uint8_t m = 1; m < NB_MAGNITUDES; ++m)
+    {
+        if (conversion.gain(m) < conversion.gain(m - 1)) erreur(algo, "gain decroissant", m);
+    }
+}
+
+/**
+ * @brief Vérifier `convert` sur toutes les positions du joystick contre un calcul direct en flottants
+ */
+static void verifierConvert(char const * algo, joystickToMotors const & conversion)
+{
+    for (int x = -100; x <= 100; ++x)
+    {
+        for (int y = -100; y <= 100; ++y)
+        {
+            int8_t g, d;
+            conversion.convert(x, y, g, d);
+
+            long angle = lround(atan2(y / 100.0, x / 100.0) * 180 / M_PI);
+            long magnitude = lround(sqrt(x * x + y * y));
+            if (magnitude > 100) magnitude = 100;
+            long gain = angle < 0 ? -conversion.gain(magnitude) : conversion.gain(magnitude);
+            long uAngle = angle < 0 ? -angle : angle;
+            if (g != conversion.consigne(uAngle, 0) * gain / 100 || d != conversion.consigne(uAngle, 1) * gain / 100)
+            {
+                erreur(algo, "convert differe du calcul direct", x * 1000 + y);
+                return;
+            }
+        }
+    }
+}
+
+static void verifier(joystickToMotors::mapping algo, joystickToMotors const & conversion)
+{
+    char const * nom = NOMS[algo];
+    for (uint8_t a = 0; a < NB_ANGLES; ++a)
+    {
+        for (uint8_t moteur = 0; moteur < 2; ++moteur)
+        {
+            if (conversion.consigne(a, moteur) < -100 || conversion.consigne(a, moteur) > 100) erreur(nom, "consigne hors plage", a);
+        }
+    }
+
+    switch (algo)
+    {
+    case joystickToMotors::tank: verifierPoints(nom, conversion, COURBE_CHENILLES, sizeof(COURBE_CHENILLES) / sizeof(COURBE_CHENILLES[0])); break;
+    case joystickToMotors::arcade: verifierPoints(nom, conversion, COURBE_ARCADE, sizeof(COURBE_ARCADE) / sizeof(COURBE_ARCADE[0])); break;
+    default: break;
+    }
+
+    if (algo == joystickToMotors::precision) verifierGain(nom, conversion, GAIN_PRECISION, sizeof(GAIN_PRECISION) / sizeof(GAIN_PRECISION[0]));
+    else verifierGain(nom, conversion, GAIN_LINEAIRE, sizeof(GAIN_LINEAIRE) / sizeof(GAIN_LINEAIRE[0]));
+
+    verifierConvert(nom, conversion);
+}
+
+static void afficher(joystickToMotors::mapping algo, joystickToMotors const & conversion, bool csv)
+{
+    char const * nom = NOMS[algo];
+    if (csv)
+    {
+        for (uint8_t a = 0; a < NB_ANGLES; ++a) printf("angle;%s;%u;%d;%d\n", nom, a, conversion.consigne(a, 0), conversion.consigne(a, 1));
+        for (uint8_t m = 0; m < NB_MAGNITUDES; ++m) printf("magnitude;%s;%u;%u\n", nom, m, conversion.gain(m));
+        return;
+    }
+
+    printf("== %s : consignes a pleine magnitude (g gauche, d droit)\n", nom);
+    char entete[16];
+    for (uint8_t a = 0; a < NB_ANGLES; a += PAS)
+    {
+        snprintf(entete, sizeof(entete), "%3u deg", a);
+        tracerLigne(entete, conversion.consigne(a, 0), conversion.consigne(a, 1));
+    }
+    printf("== %s : gain\n", nom);
+    for (uint8_t m = 0; m < NB_MAGNITUDES; m += PAS)
+    {
+        int colonne = conversion.gain(m) * (LARGEUR - 1) / 100;
+        printf("%3u %% -> %3u  %*s\n", m, conversion.gain(m), colonne + 1, "*");
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    bool csv = argc > 1 && strcmp(argv[1], "--csv") == 0;
+
+    for (uint8_t algo = 0; algo < joystickToMotors::mappinEnumSize; ++algo)
+    {
+        joystickToMotors conversion;
+        conversion.changeMapping((joystickToMotors::mapping)algo);
+        afficher((joystickToMotors::mapping)algo, conversion, csv);
+        verifier((joystickToMotors::mapping)algo, conversion);
+    }
+
+    // Courbes définies par points : elles doivent être restituées exactement
+    static const pointDirection COURBE[] = { { 30, 100, -50 }, { 90, 80, 80 }, { 150, -50, 100 } };
+    static const pointGain GAIN[] = { { 10, 0 }, { 100, 90 } };
+    joystickToMotors conversion;
+    conversion.setCourbe(COURBE, 3);
+    conversion.setGain(GAIN, 2);
+    verifierPoints("utilisateur", conversion, COURBE, 3);
+    verifierGain("utilisateur", conversion, GAIN, 2);
+    if (conversion.consigne(0, 0) != 100 || conversion.consigne(180, 1) != 100 || conversion.gain(5) != 0)
+    {
+        erreur("utilisateur", "valeur hors des points non maintenue", 0);
+    }
+    verifierConvert("utilisateur", conversion);
+
+    if (!csv) printf("%u erreur(s)\n", nbErreurs);
+    return nbErreurs ? 1 : 0;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file decodeur_boite_noire.cpp
+ * @brief Décode le contenu de la boîte noire du bateau affiché par la commande série 'B'.
+ *
+ * Utilisation : decodeur_boite_noire < journal.txt
+ * Seules les lignes "BN" sont lues : le journal peut contenir le reste de la sortie série.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <boiteNoire.h>
+
+static char const * nomCause(uint8_t cause)
+{
+    static char const * const noms[] = { "alimentation", "externe", "brownout", "watchdog", "demande" };
+    return cause < sizeof(noms) / sizeof(noms[0]) ? noms[cause] : "?";
+}
+
+int main()
+{
+    char ligne[128];
+    unsigned nbEvenements = 0;
+
+    while (fgets(ligne, sizeof(ligne), stdin))
+    {
+        char const * debut = strstr(ligne, "BN ");
+        if (!debut) continue;
+
+        evenementBoiteNoire evt;
+        uint8_t * octets = reinterpret_cast<uint8_t *>(&evt);
+        unsigned octet;
+        int lus = 0;
+        size_t i = 0;
+        for (char const * p = debut + 2; i < sizeof(evt) && sscanf(p, " %2x%n", &octet, &lus) == 1; p += lus)
+        {
+            octets[i++] = octet;
+        }
+        if (i != sizeof(evt))
+        {
+            printf("Ligne incomplete : %s", ligne);
+            continue;
+        }
+
+        ++nbEvenements;
+        if (evt.type == EVT_DEMARRAGE) printf("\n");
+        printf("#%03u %7.1f s  seq %3u  boucle max %5u us  ", evt.numero, evt.temps / 10.0, evt.seq, evt.periodeMax * 100u);
+
+        switch (evt.type)
+        {
+        case EVT_DEMARRAGE:        printf("DEMARRAGE (reset %s)\n", nomCause(evt.donnee)); break;
+        case EVT_TRAMES_PERDUES:   printf("%u trame(s) perdue(s)\n", evt.donnee); break;
+        case EVT_TRAMES_INVALIDES: printf("%u trame(s) invalide(s)\n", evt.donnee); break;
+        case EVT_FAILSAFE:         printf("FAILSAFE : liaison perdue, arret des moteurs\n"); break;
+        case EVT_REPRISE:          printf("reprise de la liaison apres %.1f s\n", evt.donnee / 10.0); break;
+        default:                   printf("type inconnu %u\n", evt.type); break;
+        }
+    }
+
+    printf("\n%u evenement(s)\n", nbEvenements);
+    return 0;
+}
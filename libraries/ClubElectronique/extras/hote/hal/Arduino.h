@@ -0,0 +1,127 @@
+/**
+ * @file Arduino.h
+ * @brief Couche d'abstraction minimale pour compiler la bibliothèque du club sur PC.
+ *
+ * Seules les fonctions utilisées par la bibliothèque sont fournies. Le temps est une horloge virtuelle qui
+ * n'avance que par `delay()`, `delayMicroseconds()` et la mise en veille : les bancs d'essai mesurent ainsi
+ * le calcul seul. Les sorties écrites sur les broches sont conservées dans `hal::niveau` et `hal::pwm`.
+ */
+
+#pragma once
+#ifndef HAL_ARDUINO_h
+#define HAL_ARDUINO_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW  0
+
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+
+#define DEC 10
+#define HEX 16
+
+#define A0 14
+#define A1 15
+
+#define NB_BROCHES 20 ///< Broches numériques et analogiques d'un ATmega328
+
+#define F(chaine) (chaine)
+#define _BV(b) (1 << (b))
+#define constrain(x, bas, haut) ((x) < (bas) ? (bas) : ((x) > (haut) ? (haut) : (x)))
+
+#define noInterrupts()
+#define interrupts()
+
+// **Registres lus directement par la bibliothèque**
+extern volatile uint8_t PINB;
+extern volatile uint8_t PIND;
+extern volatile uint8_t MCUSR;
+extern volatile uint8_t TCCR1A;
+extern volatile uint8_t TCCR1B;
+
+// Timer 1 en comptage libre au prédiviseur de 8 : deux ticks par microseconde de l'horloge virtuelle
+#define TCNT1 ((uint16_t)(hal::tempsUs * 2))
+
+#define PORF  0
+#define EXTRF 1
+#define BORF  2
+#define WDRF  3
+
+#define CS10  0
+#define CS11  1
+#define CS12  2
+
+namespace hal
+{
+    extern unsigned long tempsUs;       ///< Horloge virtuelle (µs)
+    extern uint8_t niveau[NB_BROCHES];  ///< Dernier niveau écrit par `digitalWrite()`
+    extern int     pwm[NB_BROCHES];     ///< Dernière valeur écrite par `analogWrite()`
+    extern int     analogique[NB_BROCHES]; ///< Valeur rendue par `analogRead()`
+
+    inline void avancer(unsigned long us) { tempsUs += us; }
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+void pinMode(uint8_t broche, uint8_t mode);
+void digitalWrite(uint8_t broche, uint8_t valeur);
+int  digitalRead(uint8_t broche);
+void analogWrite(uint8_t broche, int valeur);
+int  analogRead(uint8_t broche);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+#define NOT_ON_TIMER 0
+
+uint8_t digitalPinToTimer(uint8_t broche);
+uint8_t digitalPinToBitMask(uint8_t broche);
+uint8_t digitalPinToPort(uint8_t broche);
+volatile uint8_t * portInputRegister(uint8_t port);
+
+/**
+ * @brief Port série écrit sur la sortie standard
+ */
+class Print
+{
+public:
+    size_t print(char const * chaine);
+    size_t print(char c);
+    size_t print(unsigned char valeur, int base = DEC) { return print((unsigned long)valeur, base); }
+    size_t print(int valeur, int base = DEC)           { return print((long)valeur, base); }
+    size_t print(unsigned int valeur, int base = DEC)  { return print((unsigned long)valeur, base); }
+    size_t print(long valeur, int base = DEC);
+    size_t print(unsigned long valeur, int base = DEC);
+    size_t print(double valeur, int decimales = 2);
+
+    size_t println() { return print('\n'); }
+    template<typename T> size_t println(T valeur)                { size_t n = print(valeur); return n + println(); }
+    template<typename T> size_t println(T valeur, int format)    { size_t n = print(valeur, format); return n + println(); }
+
+    size_t write(uint8_t octet) { return print((char)octet); }
+    void flush() {}
+};
+
+class HardwareSerial : public Print
+{
+public:
+    void begin(unsigned long) {}
+    int  available() { return 0; }
+    int  read() { return -1; }
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
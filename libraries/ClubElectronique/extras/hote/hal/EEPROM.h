@@ -0,0 +1,33 @@
+/**
+ * @file EEPROM.h
+ * @brief EEPROM de 1Ko simulée en mémoire vive.
+ */
+
+#pragma once
+#ifndef HAL_EEPROM_h
+#define HAL_EEPROM_h
+
+#include "Arduino.h"
+
+#define TAILLE_EEPROM 1024
+
+class EEPROMClass
+{
+public:
+    EEPROMClass() { memset(m_octets, 0xFF, sizeof(m_octets)); }
+
+    uint8_t read(int adresse) const { return m_octets[adresse]; }
+    void write(int adresse, uint8_t valeur) { m_octets[adresse] = valeur; }
+    void update(int adresse, uint8_t valeur) { m_octets[adresse] = valeur; }
+    uint16_t length() const { return TAILLE_EEPROM; }
+
+    template<typename T> T & get(int adresse, T & valeur) const { memcpy(&valeur, m_octets + adresse, sizeof(T)); return valeur; }
+    template<typename T> T const & put(int adresse, T const & valeur) { memcpy(m_octets + adresse, &valeur, sizeof(T)); return valeur; }
+
+private:
+    uint8_t m_octets[TAILLE_EEPROM];
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
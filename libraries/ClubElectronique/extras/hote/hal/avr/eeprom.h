@@ -0,0 +1,12 @@
+/**
+ * @file eeprom.h
+ * @brief EEPROM simulée : toujours prête à écrire.
+ */
+
+#pragma once
+#ifndef HAL_AVR_EEPROM_h
+#define HAL_AVR_EEPROM_h
+
+#define eeprom_is_ready() (true)
+
+#endif
@@ -0,0 +1,19 @@
+/**
+ * @file sleep.h
+ * @brief Mise en veille simulée : dormir fait avancer l'horloge virtuelle jusqu'au prochain tick du timer 0.
+ */
+
+#pragma once
+#ifndef HAL_SLEEP_h
+#define HAL_SLEEP_h
+
+#include "Arduino.h"
+
+#define SLEEP_MODE_IDLE 0
+
+inline void set_sleep_mode(uint8_t) {}
+inline void sleep_enable() {}
+inline void sleep_disable() {}
+inline void sleep_cpu() { hal::avancer(1024 - hal::tempsUs % 1024); }
+
+#endif
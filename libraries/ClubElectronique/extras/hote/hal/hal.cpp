@@ -0,0 +1,75 @@
+/**
+ * @file hal.cpp
+ * @brief Implémentation sur PC de la couche d'abstraction Arduino.
+ */
+
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "EEPROM.h"
+
+volatile uint8_t PINB = 0xFF;
+volatile uint8_t PIND = 0xFF;
+volatile uint8_t MCUSR = _BV(PORF);
+volatile uint8_t TCCR1A = 0;
+volatile uint8_t TCCR1B = 0;
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+
+namespace hal
+{
+    unsigned long tempsUs = 0;
+    uint8_t niveau[NB_BROCHES] = {};
+    int     pwm[NB_BROCHES] = {};
+    int     analogique[NB_BROCHES] = {};
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t broche, uint8_t valeur)
+{
+    if (broche < NB_BROCHES)
+    {
+        hal::niveau[broche] = valeur ? HIGH : LOW;
+        hal::pwm[broche] = valeur ? 255 : 0;
+    }
+}
+
+int digitalRead(uint8_t broche) { return broche < NB_BROCHES ? hal::niveau[broche] : LOW; }
+
+void analogWrite(uint8_t broche, int valeur)
+{
+    if (broche < NB_BROCHES) hal::pwm[broche] = valeur;
+}
+
+int analogRead(uint8_t broche) { return broche < NB_BROCHES ? hal::analogique[broche] : 0; }
+
+unsigned long millis() { return hal::tempsUs / 1000; }
+unsigned long micros() { return hal::tempsUs; }
+void delay(unsigned long ms) { hal::avancer(ms * 1000); }
+void delayMicroseconds(unsigned int us) { hal::avancer(us); }
+
+// Numérotation de l'Arduino Uno : broches 0 à 7 sur le port D, 8 à 13 sur le port B, PWM sur 3, 5, 6, 9, 10 et 11
+uint8_t digitalPinToTimer(uint8_t broche)
+{
+    switch (broche)
+    {
+    case 3: case 5: case 6: case 9: case 10: case 11: return 1;
+    default:                                         return NOT_ON_TIMER;
+    }
+}
+uint8_t digitalPinToBitMask(uint8_t broche) { return _BV(broche < 8 ? broche : (broche - 8) & 7); }
+uint8_t digitalPinToPort(uint8_t broche) { return broche < 8 ? 4 : 2; }
+volatile uint8_t * portInputRegister(uint8_t port) { return port == 4 ? &PIND : &PINB; }
+
+size_t Print::print(char const * chaine) { return fputs(chaine, stdout) < 0 ? 0 : strlen(chaine); }
+size_t Print::print(char c) { return putchar(c) < 0 ? 0 : 1; }
+size_t Print::print(long valeur, int base) { return base == HEX ? printf("%lX", valeur) : printf("%ld", valeur); }
+size_t Print::print(unsigned long valeur, int base) { return base == HEX ? printf("%lX", valeur) : printf("%lu", valeur); }
+size_t Print::print(double valeur, int decimales) { return printf("%.*f", decimales, valeur); }
@@ -0,0 +1,107 @@
+/**
+ * @file radioSimulee.h
+ * @brief Liaison nRF24L01 simulée, avec des pertes propres à chaque canal, pour les bancs de la liaison radio.
+ *
+ * Le milieu est fait de brouilleurs qui couvrent chacun une plage de canaux, par rafales (Wi-Fi, autre
+ * radio du club) ou en permanence, sur un fond de pertes aléatoires. Chaque tentative d'émission est
+ * perdue selon le pire brouilleur actif sur son canal à cet instant. Les rafales des brouilleurs sont
+ * tirées à part des pertes : à graine égale, deux simulations subissent les mêmes rafales, quel que soit
+ * le nombre de trames émises.
+ */
+
+#pragma once
+#ifndef RADIOSIMULEE_h
+#define RADIOSIMULEE_h
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Brouilleur d'une plage de canaux
+ *
+ * Permanent si `dureeMin` est nul, sinon actif pendant une durée tirée entre `dureeMin` et `dureeMax`,
+ * puis silencieux pendant une durée tirée entre `silenceMin` et `silenceMax` (ms).
+ */
+struct brouilleur
+{
+    uint8_t       canalMin;
+    uint8_t       canalMax;
+    double        perte;       ///< Probabilité de perte d'une tentative quand le brouilleur est actif
+    unsigned long dureeMin;
+    unsigned long dureeMax;
+    unsigned long silenceMin;
+    unsigned long silenceMax;
+};
+
+class radioSimulee
+{
+public:
+    radioSimulee(double perteFond, uint32_t graine)
+        : m_perteFond(perteFond), m_aleaPertes(graine | 1), m_aleaBrouilleurs((graine * 2654435761u) | 1) {}
+
+    void ajouter(brouilleur const & b)
+    {
+        m_brouilleurs.push_back(b);
+        m_etats.push_back({ b.dureeMin == 0, b.dureeMin ? tirer(b.silenceMin, b.silenceMax) : 0 });
+    }
+
+    /**
+     * @brief Tenter une émission
+     *
+     * @param canal [In] Canal de l'émission
+     * @param t     [In] Instant de l'émission (ms), croissant d'un appel à l'autre
+     * @return true si la trame passe
+     */
+    bool transmettre(uint8_t canal, unsigned long t)
+    {
+        avancer(t);
+        double perte = m_perteFond;
+        for (size_t i = 0; i < m_brouilleurs.size(); ++i)
+        {
+            brouilleur const & b = m_brouilleurs[i];
+            if (m_etats[i].actif && canal >= b.canalMin && canal <= b.canalMax && b.perte > perte) perte = b.perte;
+        }
+        return uniforme() >= perte;
+    }
+
+private:
+    struct etat
+    {
+        bool          actif;
+        unsigned long bascule;  ///< Prochain changement d'état (ms)
+    };
+
+    void avancer(unsigned long t)
+    {
+        for (size_t i = 0; i < m_brouilleurs.size(); ++i)
+        {
+            brouilleur const & b = m_brouilleurs[i];
+            if (!b.dureeMin) continue;
+            while (m_etats[i].bascule <= t)
+            {
+                m_etats[i].actif = !m_etats[i].actif;
+                m_etats[i].bascule += m_etats[i].actif ? tirer(b.dureeMin, b.dureeMax) : tirer(b.silenceMin, b.silenceMax);
+            }
+        }
+    }
+
+    static uint32_t suivant(uint32_t & alea)
+    {
+        alea ^= alea << 13;
+        alea ^= alea >> 17;
+        alea ^= alea << 5;
+        return alea;
+    }
+
+    double uniforme() { return suivant(m_aleaPertes) / 4294967296.0; }
+    unsigned long tirer(unsigned long min, unsigned long max) { return min + suivant(m_aleaBrouilleurs) % (max - min + 1); }
+
+private:
+    double                  m_perteFond;
+    uint32_t                m_aleaPertes;
+    uint32_t                m_aleaBrouilleurs;
+    std::vector<brouilleur> m_brouilleurs;
+    std::vector<etat>       m_etats;
+};
+
+#endif
@@ -0,0 +1,247 @@
+/**
+ * @file rejeu_session.cpp
+ * @brief Rejoue une session de pilotage enregistrée par la télécommande sur toute la chaîne de pilotage.
+ *
+ * Les échantillons enregistrés (commande série 'R' de la télécommande) passent, sur l'horloge virtuelle,
+ * par la lecture des boutons du joypad, `joystickToMotors`, la construction du message radio, sa
+ * vérification côté bateau, `lisseurConsigne` et `pontH`. Comme sur le bateau, chaque trame reçue donne une
+ * nouvelle consigne au lisseur, et la consigne lissée est appliquée aux moteurs toutes les PERIODE_LISSAGE
+ * ms de l'horloge virtuelle, entre les trames comme à leur arrivée. Le temps passé dans chaque étage est
+ * mesuré et les sorties des moteurs sont résumées par une empreinte : deux versions du code doivent donner
+ * la même empreinte sur la même session.
+ *
+ * Les axes sont enregistrés après `joypad::getAxis` : la conversion analogique et la calibration, propres à
+ * chaque manette, ne sont pas rejouées. Les commandes de puissance radio et de redémarrage sont ignorées.
+ *
+ * Utilisation :
+ *   stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 > session.bin   (puis 'R' pour démarrer et arrêter)
+ *   rejeu_session session.bin [--csv] [--tours N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <joypad.h>
+#include <joystickToMotors.h>
+#include <lisseurConsigne.h>
+#include <radioMessage.h>
+#include <pontH.h>
+#include <sessionManette.h>
+
+#include "banc.h"
+
+#define PWM_GAUCHE 6
+#define DIR_GAUCHE 4
+#define PWM_DROIT  5
+#define DIR_DROIT  3
+
+// Lissage du bateau (bateau.ino), pour une télécommande qui émet à chaque échantillon
+#define PERIODE_LISSAGE   10   ///< Période d'application des consignes aux moteurs (ms)
+#define RAMPE_MAX         100  ///< Durée maximale d'une rampe (ms)
+#define EXTRAPOLATION_MAX 0    ///< Prolongation d'une rampe quand une trame manque (ms)
+
+/**
+ * @brief Etages mesurés
+ */
+typedef enum
+{
+    ETAGE_JOYPAD = 0,
+    ETAGE_CONVERSION,
+    ETAGE_RADIO,
+    ETAGE_BATEAU,
+    NB_ETAGES
+} etage;
+
+static char const * const nomsEtages[NB_ETAGES] = { "joypad (boutons)", "joystickToMotors", "message radio", "lissage + pontH" };
+
+/**
+ * @brief Présenter un masque de boutons sur les ports lus par `joypad::getButton`
+ */
+static void presenterBoutons(uint8_t boutons)
+{
+    PIND = ~(boutons << 2);
+    PINB = ~(boutons >> 6);
+}
+
+/**
+ * @brief Lire une session dans un fichier
+ */
+static bool lire(char const * chemin, std::vector<echantillonManette> & session, unsigned long & nbRejets)
+{
+    FILE * fichier = fopen(chemin, "rb");
+    if (!fichier) return false;
+
+    lecteurSession lecteur;
+    echantillonManette e;
+    int octet;
+    while ((octet = fgetc(fichier)) != EOF)
+    {
+        if (lecteur.ajouter(octet, e)) session.push_back(e);
+    }
+    fclose(fichier);
+
+    nbRejets = lecteur.nbRejets();
+    return true;
+}
+
+/**
+ * @brief Moteurs du bateau : appliquer la consigne lissée à chaque période échue jusqu'à un instant
+ *
+ * @param lisseur   [In,Out] Lisseur des consignes du bateau
+ * @param pont      [In,Out] Moteurs
+ * @param prochain  [In,Out] Instant de la prochaine application (ms)
+ * @param jusqua    [In]     Instant à atteindre (ms), non compris
+ * @param temps     [In,Out] Temps cumulé dans l'étage du bateau (ns)
+ * @param empr      [In,Out] Empreinte des sorties des moteurs
+ */
+static void appliquer(lisseurConsigne & lisseur, pontH & pont, unsigned long & prochain, unsigned long jusqua,
+                      double & temps, empreinte & empr)
+{
+    typedef std::chrono::steady_clock horloge;
+
+    while ((long)(jusqua - prochain) > 0)
+    {
+        hal::avancer((prochain - millis()) * 1000);
+
+        horloge::time_point debut = horloge::now();
+        lisseur.avancer(millis());
+        pont.vitesseMoteurs(lisseur.gauche(), lisseur.droit());
+        temps += std::chrono::duration<double, std::nano>(horloge::now() - debut).count();
+
+        empr.ajouter((uint8_t)hal::pwm[PWM_GAUCHE]);
+        empr.ajouter(hal::niveau[DIR_GAUCHE]);
+        empr.ajouter((uint8_t)hal::pwm[PWM_DROIT]);
+        empr.ajouter(hal::niveau[DIR_DROIT]);
+
+        prochain += PERIODE_LISSAGE;
+    }
+    hal::avancer((jusqua - millis()) * 1000);
+}
+
+/**
+ * @brief Rejouer une session une fois
+ *
+ * @param session [In]     Echantillons à rejouer
+ * @param csv     [In]     Afficher les sorties de chaque échantillon
+ * @param temps   [In,Out] Temps cumulé dans chaque étage (ns)
+ * @param empr    [Out]    Empreinte des sorties des moteurs
+ */
+static void rejouer(std::vector<echantillonManette> const & session, bool csv, double (&temps)[NB_ETAGES], empreinte & empr)
+{
+    typedef std::chrono::steady_clock horloge;
+
+    joypad manette;
+    joystickToMotors jm;
+    joystickToMotors::mapping mapping = joystickToMotors::smooth;
+    pontH pont(PWM_GAUCHE, DIR_GAUCHE, PWM_DROIT, DIR_DROIT);
+    lisseurConsigne lisseur(PERIODE_LISSAGE, RAMPE_MAX, RAMPE_MAX, EXTRAPOLATION_MAX);
+    radioMessage msg = {};
+    radioMessage recu;
+    unsigned long prochainLissage = millis();
+
+    for (size_t i = 0; i < session.size(); ++i)
+    {
+        echantillonManette const & e = session[i];
+        appliquer(lisseur, pont, prochainLissage, millis() + e.dt, temps[ETAGE_BATEAU], empr);
+        presenterBoutons(e.boutons);
+
+        horloge::time_point t0 = horloge::now();
+        uint8_t boutons = manette.getButton();
+
+        horloge::time_point t1 = horloge::now();
+        int8_t g, d;
+        jm.convert(e.x, e.y, g, d);
+        if (boutons & maskBoutonB) { g = 100;  d = -100; }
+        if (boutons & maskBoutonD) { g = -100; d = 100;  }
+        if ((boutons & maskBoutonK) && (manette.changed() & maskBoutonK))
+        {
+            mapping = (joystickToMotors::mapping)((uint8_t)(mapping + 1) % joystickToMotors::mappinEnumSize);
+            jm.changeMapping(mapping);
+        }
+
+        horloge::time_point t2 = horloge::now();
+        msg.cmd = 0;
+        msg.gauche = g;
+        msg.droit = d;
+        ++msg.seq;
+        assignCheck(msg);
+        memcpy(&recu, &msg, sizeof(msg));
+
+        horloge::time_point t3 = horloge::now();
+        if (messageIsValid(recu))
+        {
+            lisseur.recevoir(recu.gauche, recu.droit, recu.seq, millis());
+        }
+        horloge::time_point t4 = horloge::now();
+
+        temps[ETAGE_JOYPAD]     += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        temps[ETAGE_CONVERSION] += std::chrono::duration<double, std::nano>(t2 - t1).count();
+        temps[ETAGE_RADIO]      += std::chrono::duration<double, std::nano>(t3 - t2).count();
+        temps[ETAGE_BATEAU]     += std::chrono::duration<double, std::nano>(t4 - t3).count();
+
+        if (csv)
+        {
+            printf("%lu,%d,%d,%u,%d,%d,%d,%d,%d,%d\n", millis(), e.x, e.y, boutons, g, d,
+                   hal::pwm[PWM_GAUCHE], hal::niveau[DIR_GAUCHE], hal::pwm[PWM_DROIT], hal::niveau[DIR_DROIT]);
+        }
+    }
+
+    // Laisser la dernière rampe se terminer
+    appliquer(lisseur, pont, prochainLissage, millis() + RAMPE_MAX + PERIODE_LISSAGE, temps[ETAGE_BATEAU], empr);
+}
+
+int main(int argc, char ** argv)
+{
+    if (argc < 2)
+    {
+        printf("Utilisation : %s session.bin [--csv] [--tours N]\n", argv[0]);
+        return 1;
+    }
+
+    bool csv = false;
+    unsigned long nbTours = 1;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--csv")) csv = true;
+        else if (!strcmp(argv[i], "--tours") && i + 1 < argc) nbTours = strtoul(argv[++i], nullptr, 10);
+    }
+
+    std::vector<echantillonManette> session;
+    unsigned long nbRejets = 0;
+    if (!lire(argv[1], session, nbRejets))
+    {
+        printf("Impossible de lire %s\n", argv[1]);
+        return 1;
+    }
+    if (session.empty())
+    {
+        printf("Aucun echantillon dans %s\n", argv[1]);
+        return 1;
+    }
+
+    if (csv) printf("t_ms,x,y,boutons,g,d,pwm_gauche,dir_gauche,pwm_droit,dir_droit\n");
+
+    double temps[NB_ETAGES] = {};
+    empreinte empr;
+    unsigned long debut = millis();
+    rejouer(session, csv, temps, empr);
+    unsigned long duree = millis() - debut;
+
+    for (unsigned long t = 1; t < nbTours; ++t)
+    {
+        empreinte autre;
+        rejouer(session, false, temps, autre);
+    }
+
+    if (csv) return 0;
+
+    printf("%zu echantillons, %.1f s de pilotage, %lu paquet(s) rejete(s), empreinte %08X\n",
+           session.size(), duree / 1000.0, nbRejets, (unsigned)empr.valeur());
+    for (uint8_t i = 0; i < NB_ETAGES; ++i)
+    {
+        printf("%-20s %8.1f ns/echantillon\n", nomsEtages[i], temps[i] / (session.size() * nbTours));
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file traceManette.h
+ * @brief Trace des consignes de la télécommande à la milliseconde, pour les bancs de la liaison radio.
+ *
+ * La trace vient d'une session enregistrée par la télécommande (commande série 'R') ou, à défaut, d'une
+ * trace synthétique de 60s. Chaque échantillon reste valable jusqu'au suivant. Les durées de la trace
+ * synthétique ne sont pas des multiples des périodes d'émission, pour ne pas avantager la cadence fixe.
+ */
+
+#pragma once
+#ifndef TRACEMANETTE_h
+#define TRACEMANETTE_h
+
+#include <stdio.h>
+#include <vector>
+
+#include <joystickToMotors.h>
+#include <sessionManette.h>
+
+/**
+ * @brief Consignes de la télécommande à une milliseconde donnée
+ */
+struct etat
+{
+    int8_t  gauche;
+    int8_t  droit;
+    uint8_t boutons;
+
+    bool operator!=(etat const & autre) const { return gauche != autre.gauche || droit != autre.droit || boutons != autre.boutons; }
+};
+
+/**
+ * @brief Trace synthétique de 60s, à la milliseconde : repos, dérives lentes, gestes francs et maintiens
+ */
+inline void synthetiser(std::vector<echantillonManette> & session)
+{
+    for (uint32_t t = 0; t < 60000; ++t)
+    {
+        uint32_t phase = t / 5000;   // 12 phases de 5s
+        uint32_t u = t % 5000;
+        int8_t x = 0, y = 0;
+        switch (phase % 4)
+        {
+        case 0: break;                                                                           // Manche au repos
+        case 1: y = u < 2500 ? u * 100 / 2500 : 100; x = (u / 230) % 3 - 1; break;               // Accélération puis maintien avec tremblement
+        case 2: x = (u / 470) % 2 ? 80 : -80; y = 60; break;                                     // Virages francs toutes les 0,47s
+        case 3: x = (int8_t)(u % 2000 < 1000 ? u % 2000 / 10 - 50 : 150 - u % 2000 / 10); y = 40; break; // Balayage lent
+        }
+        session.push_back({ 1, x, y, 0 });
+    }
+}
+
+/**
+ * @brief Construire la trace des consignes à partir d'une session, ou de la trace synthétique
+ *
+ * @param chemin [In]  Fichier de session, ou nullptr pour la trace synthétique
+ * @param trace  [Out] Consignes à chaque milliseconde
+ * @return false si le fichier est illisible ou vide
+ */
+inline bool tracer(char const * chemin, std::vector<etat> & trace)
+{
+    std::vector<echantillonManette> session;
+    if (chemin)
+    {
+        FILE * fichier = fopen(chemin, "rb");
+        if (!fichier)
+        {
+            fprintf(stderr, "Impossible d'ouvrir %s\n", chemin);
+            return false;
+        }
+        lecteurSession lecteur;
+        echantillonManette e;
+        int octet;
+        while ((octet = fgetc(fichier)) != EOF)
+        {
+            if (lecteur.ajouter(octet, e)) session.push_back(e);
+        }
+        fclose(fichier);
+    }
+    else
+    {
+        synthetiser(session);
+    }
+
+    joystickToMotors conversion;
+    for (size_t i = 0; i < session.size(); ++i)
+    {
+        etat e;
+        conversion.convert(session[i].x, session[i].y, e.gauche, e.droit);
+        e.boutons = session[i].boutons;
+        unsigned long dt = i + 1 < session.size() ? session[i + 1].dt : 1;
+        trace.insert(trace.end(), dt ? dt : 1, e);
+    }
+    return !trace.empty();
+}
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file ClubElectronique.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Point d'entrée de la bibliothèque commune du club.
+ *
+ * A inclure en premier dans un croquis : l'IDE Arduino ajoute alors le dossier de la bibliothèque aux
+ * chemins d'inclusion, et le croquis n'inclut ensuite que les briques dont il a besoin :
+ * - `common.h`           : traces de mise au point et plan d'occupation de l'EEPROM
+ * - `parametres.h`       : registre des paramètres réglables depuis la télécommande
+ * - `radioMessage.h`     : message radio du bateau
+ * - `trameCanaux.h`      : trame radio proportionnelle multi-canaux de l'avion
+ * - `mixeur.h`           : mixage des canaux de l'avion vers ses servos (elevons, V, différentiel, expo)
+ * - `joypad.h`           : lecture du joystick et des boutons
+ * - `joystickToMotors.h` : conversion du joystick en commandes des moteurs gauche et droit
+ * - `courbesPilotage.h`  : courbes de pilotage par points, précalculées en tables
+ * - `pointFixe.h`        : conversions d'échelle sans division, identiques à `map()`
+ * - `sessionManette.h`   : format d'enregistrement des sessions de pilotage
+ * - `politiqueEmission.h`: émission de la télécommande sur changement de consigne
+ * - `sondeRadio.h`       : mesure du temps d'aller-retour de la liaison radio
+ * - `sautFrequence.h`    : saut de fréquence et liste noire des canaux brouillés
+ * - `motorBank.h`        : pilotage de N moteurs à travers des ponts en H
+ * - `pontH.h`            : pilotage des deux moteurs du bateau
+ * - `lisseurConsigne.h`  : rampes entre les consignes reçues par le bateau
+ * - `cobs.h`             : délimitation des trames sur un port série
+ * - `passerelleSerie.h`  : pilotage du bateau depuis un PC à travers la télécommande
+ * - `veille.h`           : mise en veille entre deux traitements
+ * - `executif.h`         : cadencement des tâches et budget du processeur
+ * - `chronoDemarrage.h`  : durée jusqu'à la première trame valide
+ * - `boiteNoire.h`       : enregistrement des incidents de la liaison radio en EEPROM
+ * - `reboot.h`           : redémarrage par le watchdog
+ */
+
+#pragma once
+#ifndef CLUBELECTRONIQUE_h
+#define CLUBELECTRONIQUE_h
+
+#include "common.h"
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * @file boiteNoire.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `boiteNoire` qui enregistre en permanence les incidents de la liaison radio.
+ *
+ * Les événements sont des enregistrements de 8 octets rangés d'abord dans un petit anneau en RAM : les noter
+ * ne coûte qu'une copie. Ils sont ensuite recopiés dans un anneau en EEPROM, un octet à la fois et seulement
+ * quand l'EEPROM est libre, par `vider()` que le programme appelle dans ses moments creux. L'anneau EEPROM
+ * est parcouru en rond, ce qui répartit l'usure sur toutes ses cases.
+ *
+ * Le dernier octet écrit d'un enregistrement est son numéro d'ordre : au démarrage, la tête de l'anneau est
+ * la première case dont le numéro ne suit pas celui de la case précédente.
+ */
+
+#pragma once
+#ifndef BOITENOIRE_h
+#define BOITENOIRE_h
+
+#include <EEPROM.h>
+#include <avr/eeprom.h>
+
+#include "common.h"
+
+#define BOITE_NOIRE_RAM     8     ///< Enregistrements en attente d'écriture en RAM
+#define BOITE_NOIRE_LOT     4     ///< Enregistrements à accumuler avant de commencer à écrire
+#define BOITE_NOIRE_PERIODE 1000  ///< Période de regroupement des trames perdues et invalides (ms)
+
+/**
+ * @brief Types d'événements
+ */
+typedef enum : uint8_t
+{
+    EVT_DEMARRAGE = 0,    ///< Démarrage, `donnee` = cause du redémarrage
+    EVT_TRAMES_PERDUES,   ///< Trous dans la séquence radio, `donnee` = nombre de trames perdues
+    EVT_TRAMES_INVALIDES, ///< Trames rejetées par `messageIsValid`, `donnee` = nombre de trames
+    EVT_FAILSAFE,         ///< Liaison perdue, arrêt progressif des moteurs
+    EVT_REPRISE,          ///< Liaison retrouvée, `donnee` = durée du silence (dixièmes de seconde)
+    EVT_VIDE = 0xFF       ///< Case d'EEPROM jamais écrite
+} typeEvenement;
+
+/**
+ * @brief Enregistrement de la boîte noire, tel que stocké en EEPROM
+ */
+typedef struct
+{
+    uint8_t  type;        ///< Type de l'événement (typeEvenement)
+    uint8_t  seq;         ///< Dernier numéro de séquence radio reçu
+    uint8_t  donnee;      ///< Information propre au type d'événement
+    uint8_t  reserve;
+    uint16_t temps;       ///< Instant de l'événement (dixièmes de seconde depuis le démarrage)
+    uint8_t  periodeMax;  ///< Période maximale de la boucle principale (centaines de µs, saturée)
+    uint8_t  numero;      ///< Numéro d'ordre modulo 256, écrit en dernier
+} evenementBoiteNoire;
+
+#define BOITE_NOIRE_NB ((EEPROM_BOITE_NOIRE_FIN - EEPROM_BOITE_NOIRE) / sizeof(evenementBoiteNoire)) ///< Cases de l'anneau EEPROM
+
+class boiteNoire
+{
+public:
+    inline boiteNoire();
+
+    inline void demarrer();
+
+    inline void noter(typeEvenement type, uint8_t donnee = 0, bool urgent = false);
+    inline void trame(uint8_t seq);
+    inline void trameInvalide() { if (m_nbInvalides < 255) ++m_nbInvalides; }
+    inline void tic(unsigned long maintenant, uint16_t periodeMax);
+    inline bool vider();
+
+    inline void dump() const;
+
+private:
+    static inline void afficher(evenementBoiteNoire const & evt);
+
+private:
+    evenementBoiteNoire m_attente[BOITE_NOIRE_RAM]; ///< Enregistrements pas encore écrits en EEPROM
+    uint8_t       m_premier;      ///< Plus ancien enregistrement en attente
+    uint8_t       m_nbAttente;    ///< Nombre d'enregistrements en attente
+    uint8_t       m_nbEcrases;    ///< Enregistrements perdus faute de place en RAM
+    bool          m_ecriture;     ///< Un lot est en cours d'écriture
+    uint8_t       m_octet;        ///< Prochain octet à écrire de l'enregistrement en cours
+    uint8_t       m_case;         ///< Case de l'anneau EEPROM où écrire le prochain enregistrement
+    uint8_t       m_numero;       ///< Numéro d'ordre du prochain enregistrement
+    uint8_t       m_seq;          ///< Dernier numéro de séquence reçu
+    bool          m_seqValide;    ///< Au moins une trame a été reçue
+    uint8_t       m_nbPerdues;    ///< Trames perdues depuis le dernier regroupement
+    uint8_t       m_nbInvalides;  ///< Trames invalides depuis le dernier regroupement
+    uint8_t       m_periodeMax;   ///< Dernière période maximale de la boucle (centaines de µs)
+    unsigned long m_prochainTic;  ///< Instant du prochain regroupement (ms)
+};
+
+
+
+/**
+ * @brief Constructeur de la classe boiteNoire
+ */
+inline boiteNoire::boiteNoire()
+    : m_premier(0), m_nbAttente(0), m_nbEcrases(0), m_ecriture(false), m_octet(0), m_case(0), m_numero(0),
+      m_seq(0), m_seqValide(false), m_nbPerdues(0), m_nbInvalides(0), m_periodeMax(0), m_prochainTic(0)
+{
+}
+
+/**
+ * @brief Retrouver la tête de l'anneau EEPROM
+ *
+ * A appeler une fois dans `setup()`, avant de noter le premier événement.
+ */
+inline void boiteNoire::demarrer()
+{
+    evenementBoiteNoire evt;
+    EEPROM.get(EEPROM_BOITE_NOIRE, evt);
+    if (evt.type == EVT_VIDE) return;
+
+    uint8_t numero = evt.numero;
+    for (uint8_t i = 1; i <= BOITE_NOIRE_NB; ++i)
+    {
+        uint8_t suivant = EEPROM.read(EEPROM_BOITE_NOIRE + (i % BOITE_NOIRE_NB) * sizeof(evt) + sizeof(evt) - 1);
+        if (suivant != (uint8_t)(numero + 1))
+        {
+            m_case = i % BOITE_NOIRE_NB;
+            m_numero = numero + 1;
+            return;
+        }
+        numero = suivant;
+    }
+}
+
+/**
+ * @brief Noter un événement
+ *
+ * L'événement est seulement copié en RAM. Si la RAM est pleine, le plus ancien événement en attente est perdu,
+ * ou le nouveau si le plus ancien est en cours d'écriture.
+ *
+ * @param type   [In] Type de l'événement
+ * @param donnee [In] Information propre au type d'événement
+ * @param urgent [In] Commencer l'écriture en EEPROM sans attendre un lot complet
+ */
+inline void boiteNoire::noter(typeEvenement type, uint8_t donnee, bool urgent)
+{
+    if (m_nbAttente == BOITE_NOIRE_RAM)
+    {
+        if (m_nbEcrases < 255) ++m_nbEcrases;
+        if (m_ecriture) return; // l'enregistrement en cours d'écriture ne doit pas changer
+        m_premier = (m_premier + 1) % BOITE_NOIRE_RAM;
+        --m_nbAttente;
+    }
+
+    evenementBoiteNoire & evt = m_attente[(m_premier + m_nbAttente) % BOITE_NOIRE_RAM];
+    evt.type = type;
+    evt.seq = m_seq;
+    evt.donnee = donnee;
+    evt.reserve = 0;
+    evt.temps = millis() / 100;
+    evt.periodeMax = m_periodeMax;
+    evt.numero = 0;
+    ++m_nbAttente;
+
+    if (urgent) m_ecriture = true;
+}
+
+/**
+ * @brief Signaler une trame valide et compter les trames perdues d'après son numéro de séquence
+ *
+ * @param seq [In] Numéro de séquence de la trame
+ */
+inline void boiteNoire::trame(uint8_t seq)
+{
+    if (m_seqValide)
+    {
+        uint8_t perdues = seq - m_seq - 1;
+        m_nbPerdues = perdues > 255 - m_nbPerdues ? 255 : m_nbPerdues + perdues;
+    }
+    m_seq = seq;
+    m_seqValide = true;
+}
+
+/**
+ * @brief Regrouper les trames perdues et invalides en un événement toutes les BOITE_NOIRE_PERIODE ms
+ *
+ * @param maintenant [In] Instant présent (ms)
+ * @param periodeMax [In] Période maximale de la boucle principale (µs), recopiée dans les événements suivants
+ */
+inline void boiteNoire::tic(unsigned long maintenant, uint16_t periodeMax)
+{
+    if ((long)(maintenant - m_prochainTic) < 0) return;
+    m_prochainTic = maintenant + BOITE_NOIRE_PERIODE;
+
+    m_periodeMax = periodeMax > 25500 ? 255 : periodeMax / 100;
+
+    if (m_nbPerdues)
+    {
+        noter(EVT_TRAMES_PERDUES, m_nbPerdues);
+        m_nbPerdues = 0;
+    }
+    if (m_nbInvalides)
+    {
+        noter(EVT_TRAMES_INVALIDES, m_nbInvalides);
+        m_nbInvalides = 0;
+    }
+}
+
+/**
+ * @brief Ecrire au plus un octet en EEPROM
+ *
+ * Ne fait rien tant qu'un lot n'est pas prêt ou que l'EEPROM est occupée par l'écriture précédente
+ * (environ 3,4ms par octet) : l'appel ne bloque jamais. Les octets inchangés ne sont pas réécrits.
+ *
+ * @return true si un octet a été traité
+ */
+inline bool boiteNoire::vider()
+{
+    if (!m_ecriture)
+    {
+        if (m_nbAttente < BOITE_NOIRE_LOT) return false;
+        m_ecriture = true;
+    }
+    if (!eeprom_is_ready()) return false;
+
+    // Le numéro d'ordre n'est attribué qu'à l'écriture : les numéros restent consécutifs en EEPROM
+    if (m_octet == 0) m_attente[m_premier].numero = m_numero;
+
+    uint8_t const * octets = reinterpret_cast<uint8_t const *>(&m_attente[m_premier]);
+    EEPROM.update(EEPROM_BOITE_NOIRE + m_case * sizeof(evenementBoiteNoire) + m_octet, octets[m_octet]);
+
+    if (++m_octet < sizeof(evenementBoiteNoire)) return true;
+
+    // Enregistrement complet : passer au suivant
+    m_octet = 0;
+    ++m_numero;
+    m_case = (m_case + 1) % BOITE_NOIRE_NB;
+    m_premier = (m_premier + 1) % BOITE_NOIRE_RAM;
+    m_ecriture = --m_nbAttente != 0;
+    return true;
+}
+
+/**
+ * @brief Afficher sur le port série tous les enregistrements, du plus ancien au plus récent
+ *
+ * Chaque enregistrement est une ligne "BN" suivie de ses octets en hexadécimal, à décoder sur PC avec
+ * `decodeur_boite_noire`. Les enregistrements encore en RAM suivent ceux de l'EEPROM.
+ */
+inline void boiteNoire::dump() const
+{
+    Serial.print(F("Boite noire : "));
+    Serial.print(m_nbEcrases);
+    Serial.println(F(" evenement(s) perdu(s) faute de place"));
+
+    evenementBoiteNoire evt;
+    for (uint8_t i = 0; i < BOITE_NOIRE_NB; ++i)
+    {
+        EEPROM.get(EEPROM_BOITE_NOIRE + ((m_case + i) % BOITE_NOIRE_NB) * sizeof(evt), evt);
+        if (evt.type != EVT_VIDE) afficher(evt);
+    }
+    for (uint8_t i = 0; i < m_nbAttente; ++i)
+    {
+        evt = m_attente[(m_premier + i) % BOITE_NOIRE_RAM];
+        evt.numero = m_numero + i; // numéro qu'il recevra à l'écriture
+        afficher(evt);
+    }
+    Serial.println(F("Fin"));
+}
+
+/**
+ * @brief Afficher un enregistrement sous forme d'une ligne "BN" en hexadécimal
+ */
+inline void boiteNoire::afficher(evenementBoiteNoire const & evt)
+{
+    uint8_t const * octets = reinterpret_cast<uint8_t const *>(&evt);
+    Serial.print(F("BN"));
+    for (uint8_t i = 0; i < sizeof(evt); ++i)
+    {
+        Serial.print(' ');
+        if (octets[i] < 0x10) Serial.print('0');
+        Serial.print(octets[i], HEX);
+    }
+    Serial.println();
+}
+
+#endif
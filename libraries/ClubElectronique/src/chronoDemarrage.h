@@ -0,0 +1,101 @@
+/**
+ * @file chronoDemarrage.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `chronoDemarrage` qui mesure le temps entre la mise sous tension et la première trame valide.
+ *
+ * La durée du dernier démarrage ainsi que la meilleure et la pire durée observées sont conservées en EEPROM.
+ * Le temps est compté à partir du lancement du programme (`millis()`), le temps passé dans le bootloader
+ * n'est donc pas inclus.
+ */
+
+#pragma once
+#ifndef CHRONODEMARRAGE_h
+#define CHRONODEMARRAGE_h
+
+#include <EEPROM.h>
+
+#include "common.h"
+
+/**
+ * @brief Statistiques de démarrage telles que stockées en EEPROM
+ */
+typedef struct
+{
+    uint8_t  magic;         ///< Marqueur de validité des statistiques
+    uint16_t dernier;       ///< Durée du dernier démarrage (ms)
+    uint16_t meilleur;      ///< Durée du démarrage le plus rapide (ms)
+    uint16_t pire;          ///< Durée du démarrage le plus lent (ms)
+    uint16_t nbDemarrages;  ///< Nombre de démarrages mesurés
+} statsDemarrage;
+
+class chronoDemarrage
+{
+public:
+    inline chronoDemarrage() : m_fait(false) {}
+
+    inline void trameValide();
+    inline void rapport() const;
+
+private:
+    bool m_fait; ///< La première trame valide a déjà été enregistrée
+};
+
+
+
+/**
+ * @brief Signaler la réception (ou l'émission acquittée) d'une trame valide
+ *
+ * Seul le premier appel depuis le démarrage est enregistré, les suivants ne coûtent qu'un test.
+ */
+inline void chronoDemarrage::trameValide()
+{
+    if (m_fait) return;
+    m_fait = true;
+
+    unsigned long maintenant = millis();
+    uint16_t duree = maintenant > 0xFFFF ? 0xFFFF : maintenant;
+
+    statsDemarrage stats;
+    EEPROM.get(EEPROM_DEMARRAGE, stats);
+    if (stats.magic != EEPROM_MAGIC)
+    {
+        stats.magic = EEPROM_MAGIC;
+        stats.meilleur = 0xFFFF;
+        stats.pire = 0;
+        stats.nbDemarrages = 0;
+    }
+
+    stats.dernier = duree;
+    if (duree < stats.meilleur) stats.meilleur = duree;
+    if (duree > stats.pire) stats.pire = duree;
+    ++stats.nbDemarrages;
+
+    EEPROM.put(EEPROM_DEMARRAGE, stats);
+}
+
+/**
+ * @brief Afficher les statistiques de démarrage sur le port série
+ */
+inline void chronoDemarrage::rapport() const
+{
+    statsDemarrage stats;
+    EEPROM.get(EEPROM_DEMARRAGE, stats);
+    if (stats.magic != EEPROM_MAGIC)
+    {
+        Serial.println(F("Aucun demarrage mesure"));
+        return;
+    }
+
+    Serial.print(F("Premiere trame apres "));
+    Serial.print(stats.dernier);
+    Serial.print(F(" ms (min "));
+    Serial.print(stats.meilleur);
+    Serial.print(F(" max "));
+    Serial.print(stats.pire);
+    Serial.print(F(" sur "));
+    Serial.print(stats.nbDemarrages);
+    Serial.println(F(" demarrages)"));
+}
+
+#endif
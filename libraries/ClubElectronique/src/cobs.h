@@ -0,0 +1,124 @@
+/**
+ * @file cobs.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit le codage COBS des trames envoyées sur un port série.
+ *
+ * Le codage COBS (Consistent Overhead Byte Stuffing) retire tous les octets nuls d'une trame, au prix d'un
+ * octet de plus par tranche de 254 octets. Un octet nul peut alors marquer sans ambiguïté la fin de chaque
+ * trame : après une erreur de transmission, le récepteur se resynchronise à la trame suivante.
+ */
+
+#pragma once
+#ifndef COBS_h
+#define COBS_h
+
+#include "Arduino.h"
+
+#define COBS_TAILLE_MAX 32 ///< Taille maximale d'une trame décodée
+#define COBS_TAILLE_CODEE(n) ((n) + (n) / 254 + 2) ///< Taille d'une trame de n octets une fois codée, délimiteur compris
+#define COBS_INVALIDE   0xFF ///< Rendu par `decodeurCobs::ajouter` pour une trame tronquée ou trop longue
+
+/**
+ * @brief Coder une trame
+ *
+ * @param source [In]  Octets de la trame
+ * @param taille [In]  Nombre d'octets de la trame
+ * @param codee  [Out] Trame codée suivie du délimiteur nul, COBS_TAILLE_CODEE(taille) octets au plus
+ * @return Nombre d'octets à envoyer, délimiteur compris
+ */
+inline uint8_t encoderCobs(uint8_t const * source, uint8_t taille, uint8_t * codee)
+{
+    uint8_t code = 0;   // position de l'octet de code en cours
+    uint8_t sortie = 1;
+    uint8_t longueur = 1;
+
+    for (uint8_t i = 0; i < taille; ++i)
+    {
+        if (source[i])
+        {
+            codee[sortie++] = source[i];
+            ++longueur;
+        }
+        if (!source[i] || longueur == 0xFF)
+        {
+            codee[code] = longueur;
+            code = sortie++;
+            longueur = 1;
+        }
+    }
+    codee[code] = longueur;
+    codee[sortie++] = 0;
+    return sortie;
+}
+
+/**
+ * @brief Décode au fil de l'eau les trames COBS reçues octet par octet
+ */
+class decodeurCobs
+{
+public:
+    inline decodeurCobs() : m_nbOctets(0), m_debordement(false) {}
+
+    inline uint8_t ajouter(uint8_t octet);
+    inline uint8_t const * trame() const { return m_trame; }
+
+private:
+    uint8_t m_brut[COBS_TAILLE_CODEE(COBS_TAILLE_MAX)]; ///< Octets codés reçus depuis le dernier délimiteur
+    uint8_t m_trame[COBS_TAILLE_MAX];                    ///< Dernière trame décodée
+    uint8_t m_nbOctets;                                  ///< Nombre d'octets dans `m_brut`
+    bool    m_debordement;                               ///< La trame en cours est trop longue
+};
+
+
+
+/**
+ * @brief Ajouter un octet reçu
+ *
+ * Deux délimiteurs qui se suivent (resynchronisation) ou une trame vide ne sont pas des erreurs : seules
+ * les trames mal codées ou plus longues que COBS_TAILLE_MAX rendent COBS_INVALIDE.
+ *
+ * @param octet [In] Octet reçu
+ * @return Taille de la trame décodée si l'octet est un délimiteur qui termine une trame valide,
+ *         COBS_INVALIDE s'il termine une trame invalide, 0 sinon
+ */
+inline uint8_t decodeurCobs::ajouter(uint8_t octet)
+{
+    static_assert(COBS_TAILLE_MAX < COBS_INVALIDE, "COBS_INVALIDE ne doit pas être une taille de trame");
+
+    if (octet)
+    {
+        if (m_nbOctets < sizeof(m_brut)) m_brut[m_nbOctets++] = octet;
+        else m_debordement = true;
+        return 0;
+    }
+
+    uint8_t nbOctets = m_nbOctets;
+    bool debordement = m_debordement;
+    m_nbOctets = 0;
+    m_debordement = false;
+    if (debordement) return COBS_INVALIDE;
+    if (nbOctets == 0) return 0;
+
+    uint8_t taille = 0;
+    uint8_t i = 0;
+    while (i < nbOctets)
+    {
+        uint8_t code = m_brut[i++];
+        if (i + code - 1 > nbOctets) return COBS_INVALIDE; // bloc tronqué
+
+        for (uint8_t j = 1; j < code; ++j)
+        {
+            if (taille == COBS_TAILLE_MAX) return COBS_INVALIDE;
+            m_trame[taille++] = m_brut[i++];
+        }
+        if (code < 0xFF && i < nbOctets)
+        {
+            if (taille == COBS_TAILLE_MAX) return COBS_INVALIDE;
+            m_trame[taille++] = 0;
+        }
+    }
+    return taille;
+}
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @file common.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définitions communes aux projets du club : traces de mise au point et plan d'occupation de l'EEPROM.
+ */
+
+#pragma once
+#ifndef COMMON_h
+#define COMMON_h
+
+#ifdef BATEAU_DEBUG
+#define debug(...) Serial.print(__VA_ARGS__);
+#define debugln(...) Serial.println(__VA_ARGS__);
+#else
+#define debug(...)
+#define debugln(...)
+#endif
+
+// **Plan d'occupation de l'EEPROM**
+#define EEPROM_MAGIC              0xB7 ///< Marqueur indiquant qu'une zone de l'EEPROM a été initialisée
+#define EEPROM_CALIBRATION_PONTH  0x000 ///< Calibration des moteurs (pontH)
+#define EEPROM_DEMARRAGE          0x020 ///< Durées de démarrage jusqu'à la première trame valide
+#define EEPROM_PARAMETRES         0x040 ///< Paramètres réglables de la télécommande (parametres.h)
+#define EEPROM_BOITE_NOIRE        0x100 ///< Début de l'anneau de la boîte noire du bateau
+#define EEPROM_BOITE_NOIRE_FIN    0x300 ///< Fin (exclue) de l'anneau de la boîte noire du bateau
+
+#endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+/**
+ * @file courbesPilotage.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit les courbes de pilotage de `joystickToMotors` : tables de points et leur précalcul.
+ *
+ * Une courbe de direction donne les consignes gauche et droite à pleine magnitude en fonction de l'angle
+ * du joystick (0° à droite, 90° tout droit, 180° à gauche ; les angles négatifs sont symétriques, en
+ * marche arrière). Une courbe de gain donne la magnitude appliquée en fonction de celle du joystick.
+ * Les deux sont décrites par quelques points reliés linéairement, puis précalculées une fois pour toutes
+ * en tables indexées par l'angle (0 à 180) et par la magnitude (0 à 100).
+ */
+
+#pragma once
+#ifndef COURBESPILOTAGE_h
+#define COURBESPILOTAGE_h
+
+#include "Arduino.h"
+
+#define NB_ANGLES     181 ///< Angles de 0 à 180 degrés
+#define NB_MAGNITUDES 101 ///< Magnitudes de 0 à 100
+
+/**
+ * @brief Point d'une courbe de direction
+ */
+typedef struct
+{
+    uint8_t angle;   ///< Angle du joystick (0 à 180 degrés), croissant d'un point au suivant
+    int8_t  gauche;  ///< Consigne du moteur gauche à pleine magnitude (-100 à 100)
+    int8_t  droit;   ///< Consigne du moteur droit à pleine magnitude (-100 à 100)
+} pointDirection;
+
+/**
+ * @brief Point d'une courbe de gain
+ */
+typedef struct
+{
+    uint8_t magnitude; ///< Magnitude du joystick (0 à 100), croissante d'un point au suivant
+    uint8_t gain;      ///< Magnitude appliquée (0 à 100)
+} pointGain;
+
+/**
+ * @brief Chenilles : pivot sur place joystick à l'horizontale, sinon la chenille intérieure ralentit
+ */
+static const pointDirection COURBE_CHENILLES[] =
+{
+    {   0,  100, -100 },
+    {  20,  100,    0 },
+    {  90,  100,  100 },
+    { 160,    0,  100 },
+    { 180, -100,  100 },
+};
+
+/**
+ * @brief Arcade : gauche = y + x, droit = y - x, bornés, relevés tous les 15 degrés
+ */
+static const pointDirection COURBE_ARCADE[] =
+{
+    {   0,  100, -100 },
+    {  15,  100,  -71 },
+    {  30,  100,  -37 },
+    {  45,  100,    0 },
+    {  60,  100,   37 },
+    {  75,  100,   71 },
+    {  90,  100,  100 },
+    { 105,   71,  100 },
+    { 120,   37,  100 },
+    { 135,    0,  100 },
+    { 150,  -37,  100 },
+    { 165,  -71,  100 },
+    { 180, -100,  100 },
+};
+
+/**
+ * @brief Gain linéaire : la magnitude du joystick est appliquée telle quelle
+ */
+static const pointGain GAIN_LINEAIRE[] =
+{
+    {   0,   0 },
+    { 100, 100 },
+};
+
+/**
+ * @brief Gain de précision : faible autour du centre pour manœuvrer finement, plein gain en butée
+ */
+static const pointGain GAIN_PRECISION[] =
+{
+    {   0,   0 },
+    {  50,  20 },
+    {  80,  50 },
+    { 100, 100 },
+};
+
+/**
+ * @brief Précalculer une courbe de direction
+ *
+ * Avant le premier point et après le dernier, la valeur du point extrême est conservée.
+ *
+ * @param points [In]  Points de la courbe, par angle croissant
+ * @param nb     [In]  Nombre de points (au moins 1)
+ * @param table  [Out] Consignes gauche et droite pour chaque angle
+ */
+inline void cuireDirection(pointDirection const * points, uint8_t nb, int8_t (&table)[NB_ANGLES][2])
+{
+    uint8_t i = 0;
+    for (uint16_t angle = 0; angle < NB_ANGLES; ++angle)
+    {
+        while (i + 1 < nb && points[i + 1].angle <= angle) ++i;
+
+        pointDirection const & a = points[i];
+        if (angle <= a.angle || i + 1 >= nb)
+        {
+            table[angle][0] = a.gauche;
+            table[angle][1] = a.droit;
+            continue;
+        }
+
+        pointDirection const & b = points[i + 1];
+        table[angle][0] = map(angle, a.angle, b.angle, a.gauche, b.gauche);
+        table[angle][1] = map(angle, a.angle, b.angle, a.droit, b.droit);
+    }
+}
+
+/**
+ * @brief Précalculer une courbe de gain
+ *
+ * @param points [In]  Points de la courbe, par magnitude croissante
+ * @param nb     [In]  Nombre de points (au moins 1)
+ * @param table  [Out] Magnitude appliquée pour chaque magnitude du joystick
+ */
+inline void cuireGain(pointGain const * points, uint8_t nb, uint8_t (&table)[NB_MAGNITUDES])
+{
+    uint8_t i = 0;
+    for (uint8_t magnitude = 0; magnitude < NB_MAGNITUDES; ++magnitude)
+    {
+        while (i + 1 < nb && points[i + 1].magnitude <= magnitude) ++i;
+
+        pointGain const & a = points[i];
+        if (magnitude <= a.magnitude || i + 1 >= nb)
+        {
+            table[magnitude] = a.gain;
+            continue;
+        }
+
+        pointGain const & b = points[i + 1];
+        table[magnitude] = map(magnitude, a.magnitude, b.magnitude, a.gain, b.gain);
+    }
+}
+
+#endif
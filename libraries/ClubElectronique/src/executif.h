@@ -0,0 +1,245 @@
+/**
+ * @file executif.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `executif` qui cadence les tâches d'une boucle principale et mesure leur coût.
+ *
+ * Chaque tâche est soit périodique, avec une période en microsecondes, soit à la demande (`A_LA_DEMANDE`) :
+ * elle est alors appelée à chaque tour et rend false quand elle n'avait rien à faire. Les tâches sont
+ * appelées dans l'ordre de leur ajout, qui est donc leur ordre de priorité.
+ *
+ * La durée de chaque exécution est mesurée en ticks du timer 1, libre à un demi-microseconde (prédiviseur
+ * de 8 à 16MHz). Une tâche périodique est en dépassement quand elle démarre alors que son créneau suivant
+ * est déjà échu : elle a sauté au moins un créneau, par sa propre faute ou par celle des autres tâches.
+ * Le timer 1 n'est plus disponible pour `analogWrite()` sur les broches 9 et 10.
+ */
+
+#pragma once
+#ifndef EXECUTIF_h
+#define EXECUTIF_h
+
+#include "Arduino.h"
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define TICKS_PAR_US   (F_CPU / 8000000UL) ///< Ticks du timer 1 par microseconde (prédiviseur de 8)
+#define DUREE_TICKS_MAX 16000              ///< Au-delà (µs), la durée est mesurée par `micros()`, le timer 1 ayant pu déborder
+#define A_LA_DEMANDE   0                   ///< Période d'une tâche appelée à chaque tour
+
+/**
+ * @brief Fonction d'une tâche
+ * @return false si la tâche n'avait rien à faire (tâche à la demande), true sinon
+ */
+typedef bool (*fonctionTache)();
+
+/**
+ * @brief Fonction qui affiche le nom d'une tâche à partir de son indice
+ */
+typedef void (*nomTache)(Print & sortie, uint8_t tache);
+
+template<uint8_t N>
+class executif
+{
+public:
+    inline executif() : m_nb(0), m_debutFenetre(0) {}
+
+    inline uint8_t ajouter(fonctionTache fonction, unsigned long periode);
+    inline void demarrer();
+    inline void tourner();
+    inline void recaler();
+
+    inline void remettreAZero();
+    inline uint32_t executions(uint8_t tache) const { return m_executions[tache]; }
+    inline uint16_t depassements(uint8_t tache) const { return m_depassements[tache]; }
+    inline uint32_t dureeMoyenne(uint8_t tache) const { return m_executions[tache] ? m_ticks[tache] / m_executions[tache] / TICKS_PAR_US : 0; }
+    inline uint32_t dureeMax(uint8_t tache) const { return m_ticksMax[tache] / TICKS_PAR_US; }
+    inline uint8_t charge() const;
+    inline void rapport(Print & sortie, nomTache nom) const;
+
+private:
+    static inline uint16_t ticks() { return TCNT1; }
+
+private:
+    fonctionTache m_fonction[N];     ///< Fonction de chaque tâche
+    unsigned long m_periode[N];      ///< Période de chaque tâche (µs), A_LA_DEMANDE pour une tâche à la demande
+    unsigned long m_echeance[N];     ///< Prochain créneau de chaque tâche périodique (µs)
+    uint32_t      m_ticks[N];        ///< Ticks cumulés de chaque tâche depuis le début de la fenêtre
+    uint32_t      m_ticksMax[N];     ///< Plus longue exécution de chaque tâche (ticks)
+    uint32_t      m_executions[N];   ///< Nombre d'exécutions de chaque tâche
+    uint16_t      m_depassements[N]; ///< Créneaux sautés par chaque tâche périodique
+    uint8_t       m_nb;              ///< Nombre de tâches ajoutées
+    unsigned long m_debutFenetre;    ///< Début de la fenêtre de mesure (µs)
+};
+
+
+
+/**
+ * @brief Ajouter une tâche, moins prioritaire que celles déjà ajoutées
+ *
+ * @param fonction [In] Fonction de la tâche
+ * @param periode  [In] Période de la tâche (µs), ou A_LA_DEMANDE
+ * @return Indice de la tâche, N si toutes les places sont prises
+ */
+template<uint8_t N>
+inline uint8_t executif<N>::ajouter(fonctionTache fonction, unsigned long periode)
+{
+    if (m_nb >= N) return N;
+
+    m_fonction[m_nb] = fonction;
+    m_periode[m_nb] = periode;
+    return m_nb++;
+}
+
+/**
+ * @brief Démarrer le timer 1 en comptage libre et la première fenêtre de mesure
+ */
+template<uint8_t N>
+inline void executif<N>::demarrer()
+{
+    TCCR1A = 0;
+    TCCR1B = _BV(CS11);
+    remettreAZero();
+}
+
+/**
+ * @brief Faire un tour : appeler chaque tâche à la demande et chaque tâche périodique dont le créneau est échu
+ */
+template<uint8_t N>
+inline void executif<N>::tourner()
+{
+    for (uint8_t tache = 0; tache < m_nb; ++tache)
+    {
+        unsigned long debut = micros();
+        bool periodique = m_periode[tache] != A_LA_DEMANDE;
+
+        if (periodique)
+        {
+            if ((long)(debut - m_echeance[tache]) < 0) continue;
+
+            // Créneau suivant déjà échu : compter le dépassement et repartir de maintenant
+            m_echeance[tache] += m_periode[tache];
+            if ((long)(debut - m_echeance[tache]) >= 0)
+            {
+                if (m_depassements[tache] < 0xFFFF) ++m_depassements[tache];
+                m_echeance[tache] = debut + m_periode[tache];
+            }
+        }
+
+        uint16_t debutTicks = ticks();
+        if (!m_fonction[tache]() && !periodique) continue;
+
+        // Mesures remises à zéro par la tâche elle-même (rapport, calibration) : exécution non comptée
+        if ((long)(m_debutFenetre - debut) > 0) continue;
+
+        unsigned long duree = micros() - debut;
+        uint32_t ecoule = duree < DUREE_TICKS_MAX ? (uint16_t)(ticks() - debutTicks) : duree * TICKS_PAR_US;
+
+        m_ticks[tache] += ecoule;
+        if (ecoule > m_ticksMax[tache]) m_ticksMax[tache] = ecoule;
+        ++m_executions[tache];
+    }
+}
+
+/**
+ * @brief Repartir des prochains créneaux après une pause voulue (veille, calibration), sans dépassement
+ */
+template<uint8_t N>
+inline void executif<N>::recaler()
+{
+    unsigned long maintenant = micros();
+    for (uint8_t tache = 0; tache < m_nb; ++tache)
+    {
+        m_echeance[tache] = maintenant;
+    }
+}
+
+/**
+ * @brief Remettre les mesures à zéro et commencer une nouvelle fenêtre, à partir des prochains créneaux
+ *
+ * Peut être appelée depuis une tâche, par exemple après l'affichage du rapport.
+ */
+template<uint8_t N>
+inline void executif<N>::remettreAZero()
+{
+    for (uint8_t tache = 0; tache < N; ++tache)
+    {
+        m_ticks[tache] = 0;
+        m_ticksMax[tache] = 0;
+        m_executions[tache] = 0;
+        m_depassements[tache] = 0;
+    }
+    m_debutFenetre = micros();
+    recaler();
+}
+
+/**
+ * @brief Part du temps passé dans les tâches depuis le début de la fenêtre
+ * @return Charge du processeur en pourcentage
+ */
+template<uint8_t N>
+inline uint8_t executif<N>::charge() const
+{
+    unsigned long fenetre = micros() - m_debutFenetre;
+    if (!fenetre) return 0;
+
+    uint32_t total = 0;
+    for (uint8_t tache = 0; tache < m_nb; ++tache)
+    {
+        total += m_ticks[tache];
+    }
+    // En 64 bits : total * 100 déborde 32 bits dès 43s cumulées dans les tâches
+    uint32_t pourcent = (uint64_t)total * 100 / ((uint64_t)fenetre * TICKS_PAR_US);
+    return pourcent > 100 ? 100 : pourcent;
+}
+
+/**
+ * @brief Afficher le budget du processeur depuis le début de la fenêtre
+ *
+ * Une ligne par tâche : période (µs, 0 à la demande), exécutions, durées moyenne et maximale (µs),
+ * charge (%) et dépassements, séparés par des tabulations. La dernière ligne donne le temps libre,
+ * scrutation à vide des tâches à la demande comprise.
+ *
+ * @param sortie [In] Flux de sortie
+ * @param nom    [In] Fonction qui affiche le nom d'une tâche
+ */
+template<uint8_t N>
+inline void executif<N>::rapport(Print & sortie, nomTache nom) const
+{
+    unsigned long fenetre = micros() - m_debutFenetre;
+    double fenetreTicks = (double)fenetre * TICKS_PAR_US;
+    double occupe = 0;
+
+    sortie.print(F("Fenetre "));
+    sortie.print(fenetre / 1000);
+    sortie.println(F(" ms"));
+    sortie.println(F("tache\tperiode\texec\tmoy\tmax\tcharge\tdepass."));
+
+    for (uint8_t tache = 0; tache < m_nb; ++tache)
+    {
+        double part = fenetreTicks ? 100.0 * m_ticks[tache] / fenetreTicks : 0.0;
+        occupe += part;
+
+        nom(sortie, tache);
+        sortie.print('\t');
+        sortie.print(m_periode[tache]);
+        sortie.print('\t');
+        sortie.print(m_executions[tache]);
+        sortie.print('\t');
+        sortie.print(m_executions[tache] ? (double)m_ticks[tache] / m_executions[tache] / TICKS_PAR_US : 0.0, 1);
+        sortie.print('\t');
+        sortie.print(dureeMax(tache));
+        sortie.print('\t');
+        sortie.print(part, 1);
+        sortie.print('\t');
+        sortie.print(m_depassements[tache]);
+        sortie.println();
+    }
+
+    sortie.print(F("libre\t\t\t\t\t"));
+    sortie.print(occupe < 100.0 ? 100.0 - occupe : 0.0, 1);
+    sortie.println();
+}
+
+#endif
@@ -13,6 +13,8 @@
 
 #include "Arduino.h"
 
+#include "pointFixe.h"
+
  // **Déclaration des boutons et des broches correspondantes**
 #define pinBoutonA 2 ///< Broche du bouton A
 #define pinBoutonB 3 ///< Broche du bouton B
@@ -147,6 +149,14 @@ private:
     int16_t m_yMin;
     int16_t m_yOri;
     int16_t m_yMax;
+
+    /**
+     * @brief Échelles des axes X et Y, côté négatif puis côté positif, recalculées après chaque calibrage
+     */
+    echelle m_echelleX[2];
+    echelle m_echelleY[2];
+
+    inline void preparerEchelles();
 };
 
 
@@ -172,6 +182,8 @@ joypad::joypad()
     m_yMin = m_xMin;                 // Valeur initiale pour la valeur minimale de l'axe Y
     m_yOri = m_xOri;                 // Valeur initiale pour la valeur à l'origine de l'axe Y
     m_yMax = m_xMax;                 // Valeur initiale pour la valeur maximale de l'axe Y
+
+    preparerEchelles();
 }
 
 // **Définition du destructeur de la classe joypad (ne fait rien)**
@@ -200,6 +212,8 @@ void joypad::calibration(uint8_t const & pin)
         m_xMin = x < m_xMin ? x : m_xMin;
         m_yMin = y < m_yMin ? y : m_yMin;
     }
+
+    preparerEchelles();
 }
 
 // **Définition de la fonction de lightCalibration**
@@ -207,6 +221,17 @@ void joypad::lightCalibration()
 {
     m_xOri = analogRead(A0) >> 1;
     m_yOri = analogRead(A1) >> 1;
+
+    preparerEchelles();
+}
+
+// **Définition de la fonction de préparation des échelles des axes (les divisions de map() sont faites ici)**
+void joypad::preparerEchelles()
+{
+    m_echelleX[0] = echelle(m_xMin, m_xOri, -100, 0);
+    m_echelleX[1] = echelle(m_xOri, m_xMax, 0, 100);
+    m_echelleY[0] = echelle(m_yMin, m_yOri, -100, 0);
+    m_echelleY[1] = echelle(m_yOri, m_yMax, 0, 100);
 }
 
 // **Définition de la fonction de lecture des axes**
@@ -217,20 +242,20 @@ void joypad::getAxis(int8_t &x, int8_t &y)
 
     if (ax < m_xOri)
     {
-        x = map(ax, m_xMin, m_xOri, -100, 0); // Mappage de la valeur de l'axe X entre -100 et 0
+        x = m_echelleX[0](ax);               // Mappage de la valeur de l'axe X entre -100 et 0
     }
     else
     {
-        x = map(ax, m_xOri, m_xMax, 0, 100); // Mappage de la valeur de l'axe X entre   0 et 100
+        x = m_echelleX[1](ax);               // Mappage de la valeur de l'axe X entre   0 et 100
     }
 
     if (ay < m_yOri)
     {
-        y = map(ay, m_yMin, m_yOri, -100, 0); // Mappage de la valeur de l'axe Y entre -100 et 0
+        y = m_echelleY[0](ay);               // Mappage de la valeur de l'axe Y entre -100 et 0
     }
     else
     {
-        y = map(ay, m_yOri, m_yMax, 0, 100); // Mappage de la valeur de l'axe Y entre   0 et 100
+        y = m_echelleY[1](ay);               // Mappage de la valeur de l'axe Y entre   0 et 100
     }
 }
 
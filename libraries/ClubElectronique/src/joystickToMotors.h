@@ -9,12 +9,23 @@
 #ifndef JOYSTICKTOMOTORS_h
 #define JOYSTICKTOMOTORS_h
 
+#include "Arduino.h"
+
+#include "courbesPilotage.h"
+#include "pointFixe.h"
+
+constexpr reciproque RECIPROQUE_CENT(100);                    ///< Division par 100 de la magnitude
+constexpr echelle    ECHELLE_SIMPLE_DROIT(0, 90, 0, 100);      ///< Moteur droit de l'algorithme simple, de 0 à 90°
+constexpr echelle    ECHELLE_SIMPLE_GAUCHE(90, 180, 100, 0);   ///< Moteur gauche de l'algorithme simple, de 90 à 180°
 
  /**
   * @brief Classe pour la conversion des commandes du joystick en commandes pour les moteurs
   *
   * Cette classe permet de convertir les valeurs brutes du joystick (axes X et Y) en commandes pour les moteurs gauche et droit (g et d).
-  * Elle prend en compte l'angle du joystick (calculé à partir des axes X et Y) et l'algorithme de conversion sélectionné (simple ou lisse).
+  * Elle prend en compte l'angle du joystick (calculé à partir des axes X et Y) et l'algorithme de conversion sélectionné.
+  * Chaque algorithme est précalculé, à sa sélection, en une table des consignes par angle et une table du gain par magnitude :
+  * une conversion se réduit ensuite à deux lectures de table. Des courbes définies par points (voir courbesPilotage.h)
+  * peuvent remplacer celles de l'algorithme sélectionné.
   */
 class joystickToMotors
 {
@@ -25,31 +36,91 @@ public:
     enum mapping : uint8_t {
         simple, /**< Algorithme de conversion simple */
         smooth, /**< Algorithme de conversion lisse */
+        tank, /**< Chenilles : pivot sur place joystick à l'horizontale */
+        arcade, /**< Arcade : gauche = y + x, droit = y - x */
+        precision, /**< Algorithme lisse avec un gain faible autour du centre */
         mappinEnumSize  /**< Taille de l'énumération (utilisé en interne) */
     };
 
 public:
-    joystickToMotors() { m_angle = 45; m_algo = smooth; }
+    joystickToMotors() { m_algo = smooth; setAngleSeuil(45); }
     ~joystickToMotors() = default;
 
     void convert(int8_t x, int8_t y, int8_t &g, int8_t &d) const;
-    void setAngleSeuil(int8_t angle) { m_angle = angle; }
-    void changeMapping(mapping algo) { m_algo = algo; }
+    inline void setAngleSeuil(int8_t angle);
+    void changeMapping(mapping algo) { m_algo = algo; cuire(); }
+    mapping getMapping() const { return m_algo; }
+
+    void setCourbe(pointDirection const * points, uint8_t nb) { cuireDirection(points, nb, m_table); }
+    void setGain(pointGain const * points, uint8_t nb) { cuireGain(points, nb, m_gain); }
+    int8_t consigne(uint8_t uAngle, uint8_t moteur) const { return m_table[uAngle][moteur]; }
+    uint8_t gain(uint8_t magnitude) const { return m_gain[magnitude]; }
 
 private:
     inline void xyToPolar(int8_t x, int8_t y, double &angle, uint8_t &magnitude) const;
     inline void polaireToMotor(double angle, int8_t magnitude, int8_t &g, int8_t &d) const;
 
+    inline void cuire();
     inline void simpleConversion(long uAngle, long &g, long &d) const;
     inline void smoothConversion(long uAngle, long &g, long &d) const;
 
 private:
     int m_angle;    /**< Angle de seuil pour l'algorithme de conversion lisse (degrés) */
-    mapping m_algo; /**< Algorithme de conversion sélectionné (simple ou lisse) */
+    mapping m_algo; /**< Algorithme de conversion sélectionné */
+    echelle m_lisse[4]; /**< Échelles de l'algorithme lisse pour `m_angle`, de la zone la plus proche de 180° à celle de 0° */
+    int8_t m_table[NB_ANGLES][2]; /**< Consignes gauche et droite à pleine magnitude, pour chaque angle de 0 à 180° */
+    uint8_t m_gain[NB_MAGNITUDES]; /**< Magnitude appliquée, pour chaque magnitude du joystick */
 };
 
 
 
+/**
+ * @brief Définit l'angle de seuil pour l'algorithme de conversion lisse
+ *
+ * Les échelles de l'algorithme lisse sont recalculées ici, une fois pour toutes, plutôt qu'à chaque conversion,
+ * et les tables sont précalculées de nouveau.
+ *
+ * @param angle Angle de seuil en degrés (int8_t)
+ */
+inline void joystickToMotors::setAngleSeuil(int8_t angle)
+{
+    m_angle = angle;
+    m_lisse[0] = echelle(180 - m_angle, 180, 100, 0);
+    m_lisse[1] = echelle(90, 180 - m_angle, 100, 0);
+    m_lisse[2] = echelle(m_angle, 90, 0, 100);
+    m_lisse[3] = echelle(0, m_angle, 0, 100);
+    cuire();
+}
+
+/**
+ * @brief Précalcule les tables de l'algorithme sélectionné
+ *
+ * Les algorithmes simple et lisse sont évalués pour chaque angle : leurs consignes restent identiques à un calcul direct.
+ * Les courbes définies par `setCourbe` et `setGain` sont remplacées.
+ */
+inline void joystickToMotors::cuire()
+{
+    switch (m_algo)
+    {
+        case tank: cuireDirection(COURBE_CHENILLES, sizeof(COURBE_CHENILLES) / sizeof(COURBE_CHENILLES[0]), m_table); break;
+        case arcade: cuireDirection(COURBE_ARCADE, sizeof(COURBE_ARCADE) / sizeof(COURBE_ARCADE[0]), m_table); break;
+        default:
+            for (uint8_t uAngle = 0; uAngle < NB_ANGLES; ++uAngle)
+            {
+                long gauche = 0;
+                long droit = 0;
+                if (m_algo == simple) simpleConversion(uAngle, gauche, droit);
+                else smoothConversion(uAngle, gauche, droit);
+                m_table[uAngle][0] = gauche;
+                m_table[uAngle][1] = droit;
+            }
+            break;
+    }
+
+    if (m_algo == precision) cuireGain(GAIN_PRECISION, sizeof(GAIN_PRECISION) / sizeof(GAIN_PRECISION[0]), m_gain);
+    else cuireGain(GAIN_LINEAIRE, sizeof(GAIN_LINEAIRE) / sizeof(GAIN_LINEAIRE[0]), m_gain);
+}
+
 /**
  * @brief Convertit les valeurs du joystick en commandes pour les moteurs
  *
@@ -93,7 +164,7 @@ inline void joystickToMotors::xyToPolar(int8_t x, int8_t y, double & angle, uint
  * @brief Convertit l'angle et la magnitude polaires en commandes pour les moteurs
  *
  * Cette méthode convertit l'angle et la magnitude polaires calculés précédemment en commandes pour les moteurs gauche et droit.
- * Le choix de l'algorithme de conversion (simple ou lisse) est pris en compte.
+ * Les consignes et le gain sont lus dans les tables de l'algorithme sélectionné.
  *
  * @param angle Angle polaire (double)
  * @param magnitude Magnitude polaire (uint8_t)
@@ -103,24 +174,16 @@ inline void joystickToMotors::xyToPolar(int8_t x, int8_t y, double & angle, uint
 inline void joystickToMotors::polaireToMotor(double angle, int8_t magnitude, int8_t &g, int8_t &d) const
 {
     long uAngle = (long)angle; // Angle non signé
-    long gauche = 0;
-    long droit = 0;
+    int8_t gain = m_gain[magnitude];
 
     if (angle < 0)
     {
         uAngle = 0 - uAngle; // Convertit l'angle en positif
-        magnitude = 0 - magnitude; // Inverse la direction
-    }
-
-    switch (m_algo)
-    {
-        case simple: simpleConversion(uAngle, gauche, droit); break;
-        case smooth: smoothConversion(uAngle, gauche, droit); break;
-        default: break; // Gestion d'erreur pour un algorithme inconnu
+        gain = 0 - gain; // Inverse la direction
     }
 
-    g = (int8_t)gauche * magnitude / 100;
-    d = (int8_t)droit  * magnitude / 100;
+    g = diviserSigne(m_table[uAngle][0] * gain, RECIPROQUE_CENT);
+    d = diviserSigne(m_table[uAngle][1] * gain, RECIPROQUE_CENT);
 }
 
 /**
@@ -137,11 +200,11 @@ inline void joystickToMotors::simpleConversion(long uAngle, long &g, long &d) co
     if (uAngle < 90)
     {
         g = 100;
-        d = map(uAngle, 0, 90, 0, 100);
+        d = ECHELLE_SIMPLE_DROIT(uAngle);
     }
     else if (uAngle < 180)
     {
-        g = map(uAngle, 90, 180, 100, 0);
+        g = ECHELLE_SIMPLE_GAUCHE(uAngle);
         d = 100;
     }
 }
@@ -160,21 +223,21 @@ inline void joystickToMotors::smoothConversion(long uAngle, long &g, long &d) co
     if (uAngle > 180 - m_angle)
     {
         g = 0;
-        d = map(uAngle, 180 - m_angle, 180, 100, 0);
+        d = m_lisse[0](uAngle);
     }
     else if (uAngle > 90)
     {
-        g = map(uAngle, 90, 180 - m_angle, 100, 0);
+        g = m_lisse[1](uAngle);
         d = 100;
     }
     else if (uAngle > 90 - m_angle)
     {
         g = 100;
-        d = map(uAngle, m_angle, 90, 0, 100);
+        d = m_lisse[2](uAngle);
     }
     else
     {
-        g = map(uAngle, 0, m_angle, 0, 100);
+        g = m_lisse[3](uAngle);
         d = 0;
     }
 }
@@ -195,19 +258,31 @@ inline void joystickToMotors::smoothConversion(long uAngle, long &g, long &d) co
  */
 
 /**
- * @fn joystickToMotors::setAngleSeuil
- * @brief Définit l'angle de seuil pour l'algorithme de conversion lisse
+ * @fn joystickToMotors::setCourbe
+ * @brief Remplace la courbe de direction par une courbe définie par points
  *
- * Cette méthode permet de définir l'angle de seuil utilisé dans l'algorithme de conversion lisse. Cet angle définit une zone morte autour de l'axe central du joystick.
+ * La courbe reste en place jusqu'au prochain `changeMapping` ou `setAngleSeuil`.
  *
- * @param angle Angle de seuil en degrés (int8_t)
+ * @param points Points de la courbe, par angle croissant
+ * @param nb Nombre de points
+ */
+
+/**
+ * @fn joystickToMotors::setGain
+ * @brief Remplace la courbe de gain par une courbe définie par points
+ *
+ * La courbe reste en place jusqu'au prochain `changeMapping` ou `setAngleSeuil`.
+ *
+ * @param points Points de la courbe, par magnitude croissante
+ * @param nb Nombre de points
  */
 
 /**
  * @fn joystickToMotors::changeMapping
  * @brief Change l'algorithme de conversion utilisé
  *
- * Cette méthode permet de changer l'algorithme de conversion utilisé (simple ou lisse) en fonction de la valeur de l'énumération `mapping` fournie.
+ * Cette méthode permet de changer l'algorithme de conversion utilisé en fonction de la valeur de l'énumération `mapping` fournie.
+ * Les tables de l'algorithme sont précalculées aussitôt.
  *
  * @param algo Algorithme de conversion souhaité (joystickToMotors::mapping)
  */
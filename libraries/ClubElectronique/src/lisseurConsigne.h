@@ -0,0 +1,153 @@
+/**
+ * @file lisseurConsigne.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `lisseurConsigne` qui lisse les consignes moteurs reçues par radio.
+ *
+ * Les consignes n'arrivent qu'au rythme de la liaison radio. Le lisseur est appelé à cadence fixe et
+ * rejoint chaque nouvelle consigne par une rampe dont la durée est l'intervalle mesuré entre deux trames
+ * (corrigé des trames perdues grâce au numéro de séquence). Si la trame suivante manque, la consigne
+ * poursuit la tendance des deux dernières trames pendant un intervalle au plus (et au plus
+ * `extrapolationMax` ms), puis elle est maintenue : le failsafe du bateau prend le relais au-delà.
+ *
+ * L'extrapolation ne convient qu'à une télécommande qui émet à cadence fixe : avec une émission sur
+ * changement de consigne, une trame absente signifie que rien n'a changé (`extrapolationMax` à 0).
+ *
+ * Pour la même raison, avec une émission sur changement, un long intervalle sans trame perdue ne dit rien
+ * du rythme de la consigne : une rampe de toute sa durée ne ferait que retarder le bateau. `rampeSuivie`
+ * borne alors la rampe à la période d'échantillonnage du joystick de la télécommande ; à cadence fixe,
+ * elle vaut `rampeMax`.
+ */
+
+#pragma once
+#ifndef LISSEURCONSIGNE_h
+#define LISSEURCONSIGNE_h
+
+#include "Arduino.h"
+
+#include "pointFixe.h"
+
+class lisseurConsigne
+{
+public:
+    inline lisseurConsigne(uint16_t rampeMin, uint16_t rampeMax, uint16_t rampeSuivie, uint16_t extrapolationMax)
+        : m_rampeMin(rampeMin), m_rampeMax(rampeMax), m_rampeSuivie(rampeSuivie < rampeMax ? rampeSuivie : rampeMax),
+          m_extrapolationMax(extrapolationMax),
+          m_gauche(0), m_droit(0), m_cibleGauche(0), m_cibleDroit(0),
+          m_debut(0), m_duree(rampeMax), m_derniere(0), m_seq(0), m_premiere(true)
+    {
+        imposer(0, 0);
+    }
+
+    inline void recevoir(int8_t gauche, int8_t droit, uint8_t seq, unsigned long maintenant);
+    inline void avancer(unsigned long maintenant);
+    inline void imposer(int8_t gauche, int8_t droit);
+
+    inline int8_t gauche() const { return m_gauche; }
+    inline int8_t droit() const { return m_droit; }
+
+private:
+    static inline int8_t borner(long consigne) { return consigne > 100 ? 100 : (consigne < -100 ? -100 : consigne); }
+
+private:
+    uint16_t      m_rampeMin;          ///< Durée minimale d'une rampe (ms), la période d'appel de `avancer`
+    uint16_t      m_rampeMax;          ///< Durée maximale d'une rampe (ms)
+    uint16_t      m_rampeSuivie;       ///< Durée maximale d'une rampe quand aucune trame ne manque (ms)
+    uint16_t      m_extrapolationMax;  ///< Prolongation maximale d'une rampe quand la trame suivante manque (ms)
+    int8_t        m_gauche;            ///< Consigne lissée du moteur gauche
+    int8_t        m_droit;             ///< Consigne lissée du moteur droit
+    int8_t        m_cibleGauche;       ///< Dernière consigne reçue pour le moteur gauche
+    int8_t        m_cibleDroit;        ///< Dernière consigne reçue pour le moteur droit
+    echelle       m_rampeGauche;       ///< Rampe en cours du moteur gauche, en fonction du temps écoulé
+    echelle       m_rampeDroit;        ///< Rampe en cours du moteur droit, en fonction du temps écoulé
+    echelle       m_tendanceGauche;    ///< Écart entre les deux dernières consignes reçues, par intervalle
+    echelle       m_tendanceDroit;     ///< Écart entre les deux dernières consignes reçues, par intervalle
+    unsigned long m_debut;             ///< Début de la rampe en cours (ms)
+    uint16_t      m_duree;             ///< Durée de la rampe en cours (ms)
+    unsigned long m_derniere;          ///< Instant de réception de la dernière trame (ms)
+    uint8_t       m_seq;               ///< Numéro de séquence de la dernière trame
+    bool          m_premiere;          ///< Aucune trame reçue depuis le démarrage ou le dernier `imposer`
+};
+
+
+
+/**
+ * @brief Prendre en compte une nouvelle consigne reçue
+ *
+ * La rampe part de la consigne lissée actuelle, sans à-coup, et rejoint la nouvelle consigne en un
+ * intervalle entre trames, au plus `rampeSuivie` ms si aucune trame ne manque depuis la précédente.
+ *
+ * @param gauche     [In] Consigne reçue pour le moteur gauche (-100 à 100)
+ * @param droit      [In] Consigne reçue pour le moteur droit (-100 à 100)
+ * @param seq        [In] Numéro de séquence de la trame
+ * @param maintenant [In] Instant de réception (ms)
+ */
+inline void lisseurConsigne::recevoir(int8_t gauche, int8_t droit, uint8_t seq, unsigned long maintenant)
+{
+    uint16_t duree = m_rampeMax;
+    uint8_t ecartSeq = seq - m_seq;
+    if (!m_premiere && ecartSeq)
+    {
+        unsigned long intervalle = (maintenant - m_derniere) / ecartSeq;
+        uint16_t plafond = ecartSeq == 1 ? m_rampeSuivie : m_rampeMax;
+        duree = intervalle < m_rampeMin ? m_rampeMin : (intervalle > plafond ? plafond : intervalle);
+    }
+
+    m_rampeGauche = echelle(0, duree, m_gauche, gauche);
+    m_rampeDroit = echelle(0, duree, m_droit, droit);
+    m_tendanceGauche = echelle(0, duree, 0, m_premiere ? 0 : gauche - m_cibleGauche);
+    m_tendanceDroit = echelle(0, duree, 0, m_premiere ? 0 : droit - m_cibleDroit);
+    m_cibleGauche = gauche;
+    m_cibleDroit = droit;
+    m_debut = maintenant;
+    m_duree = duree;
+
+    m_derniere = maintenant;
+    m_seq = seq;
+    m_premiere = false;
+}
+
+/**
+ * @brief Calculer la consigne lissée à l'instant présent
+ *
+ * @param maintenant [In] Instant présent (ms)
+ */
+inline void lisseurConsigne::avancer(unsigned long maintenant)
+{
+    unsigned long ecoule = maintenant - m_debut;
+    if (ecoule <= m_duree)
+    {
+        m_gauche = m_rampeGauche(ecoule);
+        m_droit = m_rampeDroit(ecoule);
+        return;
+    }
+
+    // Trame attendue absente : poursuivre la tendance, un intervalle au plus
+    unsigned long prolongation = ecoule - m_duree;
+    uint16_t limite = m_duree < m_extrapolationMax ? m_duree : m_extrapolationMax;
+    if (prolongation > limite) prolongation = limite;
+
+    m_gauche = borner(m_cibleGauche + m_tendanceGauche(prolongation));
+    m_droit = borner(m_cibleDroit + m_tendanceDroit(prolongation));
+}
+
+/**
+ * @brief Imposer la consigne lissée, sans rampe (décroissance du failsafe, arrêt des moteurs)
+ *
+ * La trame suivante repart de cette consigne, et son intervalle n'est pas mesuré.
+ *
+ * @param gauche [In] Consigne du moteur gauche
+ * @param droit  [In] Consigne du moteur droit
+ */
+inline void lisseurConsigne::imposer(int8_t gauche, int8_t droit)
+{
+    m_gauche = m_cibleGauche = gauche;
+    m_droit = m_cibleDroit = droit;
+    m_rampeGauche = echelle(0, 1, gauche, gauche);
+    m_rampeDroit = echelle(0, 1, droit, droit);
+    m_tendanceGauche = echelle();
+    m_tendanceDroit = echelle();
+    m_premiere = true;
+}
+
+#endif
@@ -0,0 +1,285 @@
+/**
+ * @file mixeur.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `mixeur` qui calcule les sorties servo de l'avion à partir des canaux reçus.
+ *
+ * Le mixage est décrit par une table de règles (source, sortie, poids) : empennage classique, elevons,
+ * empennage en V, ailerons différentiels ou compensation de la profondeur par les gaz ne sont que des
+ * tables différentes. Les courbes expo, les poids, les trims et les fins de course sont convertis en
+ * entiers au moment de la configuration : le calcul d'une trame ne fait que des lectures de table,
+ * des multiplications entières et des décalages.
+ */
+
+#pragma once
+#ifndef MIXEUR_h
+#define MIXEUR_h
+
+#include "trameCanaux.h"
+
+#define NB_SORTIES          4                ///< Nombre de sorties servo
+#define NB_REGLES           8                ///< Nombre maximal de règles de mixage
+#define NB_ENTREES          (NB_CANAUX + 1)  ///< Canaux reçus plus les gaz comptés depuis le ralenti
+#define ENTREE_GAZ_RALENTI  NB_CANAUX        ///< Gaz de 0 (ralenti) à CANAL_MAX - CANAL_CENTRE (plein gaz)
+#define SEGMENTS_EXPO       16               ///< Nombre de segments de la courbe expo tabulée
+
+#define COURSE              (CANAL_MAX - CANAL_CENTRE) ///< Course d'une entrée ou d'une sortie de part et d'autre du neutre
+
+/**
+ * @brief Affectation des sorties servo
+ */
+typedef enum
+{
+    SORTIE_PROFONDEUR = 0, ///< Profondeur, elevon gauche ou empennage en V gauche
+    SORTIE_DIRECTION,      ///< Direction, elevon droit ou empennage en V droit
+    SORTIE_GAZ,            ///< Contrôleur moteur
+    SORTIE_AILERONS        ///< Ailerons
+} sortie;
+
+/**
+ * @brief Règle de mixage : la sortie reçoit l'entrée pondérée, avec un poids différent selon le signe de l'entrée
+ */
+typedef struct
+{
+    uint8_t source;        ///< Indice de l'entrée (canal ou ENTREE_GAZ_RALENTI)
+    uint8_t sortie;        ///< Indice de la sortie
+    int16_t poidsPositif;  ///< Poids appliqué quand l'entrée est positive, en 1/256
+    int16_t poidsNegatif;  ///< Poids appliqué quand l'entrée est négative, en 1/256
+} regleMixage;
+
+class mixeur
+{
+public:
+    inline mixeur() { effacer(); }
+
+    inline void effacer();
+    inline bool ajouterRegle(uint8_t source, uint8_t sortie, int8_t pourcentPositif, int8_t pourcentNegatif);
+    inline bool ajouterRegle(uint8_t source, uint8_t sortie, int8_t pourcent) { return ajouterRegle(source, sortie, pourcent, pourcent); }
+
+    inline void setExpo(uint8_t entree, uint8_t pourcent);
+    inline void setTrim(uint8_t sortie, int16_t trim) { m_trim[sortie] = trim; }
+    inline void setFinsDeCourse(uint8_t sortie, int16_t minimum, int16_t maximum);
+
+    inline void configurerClassique();
+    inline void configurerElevons(uint8_t differentiel = 0);
+    inline void configurerVTail();
+    inline void configurerAilerons(uint8_t differentiel);
+    inline void configurerGazProfondeur(int8_t pourcent);
+
+    inline void calculer(uint16_t const (&canaux)[NB_CANAUX], uint16_t (&sorties)[NB_SORTIES]) const;
+
+private:
+    inline int16_t expo(uint8_t entree, int16_t valeur) const;
+
+private:
+    regleMixage m_regles[NB_REGLES];                     ///< Règles de mixage
+    uint8_t     m_nbRegles;                              ///< Nombre de règles utilisées
+    int16_t     m_expo[NB_CANAUX][SEGMENTS_EXPO + 1];    ///< Courbe expo de chaque canal, tabulée de 0 à COURSE + 1
+    int16_t     m_trim[NB_SORTIES];                      ///< Décalage du neutre de chaque sortie
+    int16_t     m_min[NB_SORTIES];                       ///< Fin de course basse de chaque sortie (par rapport au neutre)
+    int16_t     m_max[NB_SORTIES];                       ///< Fin de course haute de chaque sortie (par rapport au neutre)
+};
+
+
+
+/**
+ * @brief Revenir à un mixeur vide : aucune règle, courbes linéaires, trims nuls et courses complètes
+ */
+inline void mixeur::effacer()
+{
+    m_nbRegles = 0;
+
+    for (uint8_t entree = 0; entree < NB_CANAUX; ++entree)
+    {
+        setExpo(entree, 0);
+    }
+
+    for (uint8_t sortie = 0; sortie < NB_SORTIES; ++sortie)
+    {
+        m_trim[sortie] = 0;
+        setFinsDeCourse(sortie, -COURSE, COURSE);
+    }
+}
+
+/**
+ * @brief Ajouter une règle de mixage
+ *
+ * @param source          [In] Indice de l'entrée (canal ou ENTREE_GAZ_RALENTI)
+ * @param sortie          [In] Indice de la sortie
+ * @param pourcentPositif [In] Poids en pourcent quand l'entrée est positive (négatif pour inverser)
+ * @param pourcentNegatif [In] Poids en pourcent quand l'entrée est négative
+ * @return false si la table de règles est pleine
+ */
+inline bool mixeur::ajouterRegle(uint8_t source, uint8_t sortie, int8_t pourcentPositif, int8_t pourcentNegatif)
+{
+    if (m_nbRegles >= NB_REGLES) return false;
+
+    regleMixage & regle = m_regles[m_nbRegles++];
+    regle.source = source;
+    regle.sortie = sortie;
+    regle.poidsPositif = (int16_t)pourcentPositif * 256 / 100;
+    regle.poidsNegatif = (int16_t)pourcentNegatif * 256 / 100;
+    return true;
+}
+
+/**
+ * @brief Définir l'expo d'un canal
+ *
+ * La courbe y = (1 - e).x + e.x³ (x et y normalisés) est tabulée en SEGMENTS_EXPO + 1 points.
+ *
+ * @param entree   [In] Indice du canal
+ * @param pourcent [In] Taux d'expo e, de 0 (linéaire) à 100 (cubique)
+ */
+inline void mixeur::setExpo(uint8_t entree, uint8_t pourcent)
+{
+    if (pourcent > 100) pourcent = 100;
+
+    for (uint8_t i = 0; i <= SEGMENTS_EXPO; ++i)
+    {
+        int32_t x = (int32_t)i * ((COURSE + 1) / SEGMENTS_EXPO);
+        int32_t cube = x * x / (COURSE + 1) * x / (COURSE + 1);
+        m_expo[entree][i] = ((100 - pourcent) * x + pourcent * cube) / 100;
+    }
+}
+
+/**
+ * @brief Définir les fins de course d'une sortie, par rapport à son neutre
+ *
+ * @param sortie  [In] Indice de la sortie
+ * @param minimum [In] Valeur la plus basse autorisée (-COURSE pour la course complète)
+ * @param maximum [In] Valeur la plus haute autorisée (COURSE pour la course complète)
+ */
+inline void mixeur::setFinsDeCourse(uint8_t sortie, int16_t minimum, int16_t maximum)
+{
+    m_min[sortie] = minimum;
+    m_max[sortie] = maximum;
+}
+
+/**
+ * @brief Empennage classique : chaque canal pilote directement sa sortie
+ */
+inline void mixeur::configurerClassique()
+{
+    m_nbRegles = 0;
+    ajouterRegle(CANAL_PROFONDEUR, SORTIE_PROFONDEUR, 100);
+    ajouterRegle(CANAL_DIRECTION,  SORTIE_DIRECTION,  100);
+    ajouterRegle(CANAL_GAZ,        SORTIE_GAZ,        100);
+    ajouterRegle(CANAL_AILERONS,   SORTIE_AILERONS,   100);
+}
+
+/**
+ * @brief Aile volante : profondeur et ailerons mélangés sur deux elevons
+ *
+ * @param differentiel [In] Réduction en pourcent du débattement vers le bas des elevons en roulis
+ */
+inline void mixeur::configurerElevons(uint8_t differentiel)
+{
+    int8_t reduit = 100 - (differentiel > 100 ? 100 : differentiel);
+
+    m_nbRegles = 0;
+    ajouterRegle(CANAL_PROFONDEUR, SORTIE_PROFONDEUR, 100);
+    ajouterRegle(CANAL_AILERONS,   SORTIE_PROFONDEUR, 100, reduit);
+    ajouterRegle(CANAL_PROFONDEUR, SORTIE_DIRECTION,  100);
+    ajouterRegle(CANAL_AILERONS,   SORTIE_DIRECTION,  -reduit, -100);
+    ajouterRegle(CANAL_GAZ,        SORTIE_GAZ,        100);
+}
+
+/**
+ * @brief Empennage en V : profondeur et direction mélangées sur les deux gouvernes
+ */
+inline void mixeur::configurerVTail()
+{
+    m_nbRegles = 0;
+    ajouterRegle(CANAL_PROFONDEUR, SORTIE_PROFONDEUR, 100);
+    ajouterRegle(CANAL_DIRECTION,  SORTIE_PROFONDEUR, 100);
+    ajouterRegle(CANAL_PROFONDEUR, SORTIE_DIRECTION,  100);
+    ajouterRegle(CANAL_DIRECTION,  SORTIE_DIRECTION,  -100);
+    ajouterRegle(CANAL_GAZ,        SORTIE_GAZ,        100);
+    ajouterRegle(CANAL_AILERONS,   SORTIE_AILERONS,   100);
+}
+
+/**
+ * @brief Ailerons différentiels : la règle directe des ailerons est remplacée par une règle asymétrique
+ *
+ * @param differentiel [In] Réduction en pourcent du débattement des ailerons quand le canal est négatif
+ */
+inline void mixeur::configurerAilerons(uint8_t differentiel)
+{
+    int8_t reduit = 100 - (differentiel > 100 ? 100 : differentiel);
+
+    for (uint8_t i = 0; i < m_nbRegles; ++i)
+    {
+        if (m_regles[i].source == CANAL_AILERONS && m_regles[i].sortie == SORTIE_AILERONS)
+        {
+            m_regles[i].poidsNegatif = (int16_t)reduit * 256 / 100;
+            return;
+        }
+    }
+    ajouterRegle(CANAL_AILERONS, SORTIE_AILERONS, 100, reduit);
+}
+
+/**
+ * @brief Compensation de la profondeur par les gaz
+ *
+ * @param pourcent [In] Débattement de profondeur ajouté à plein gaz, en pourcent (négatif pour piquer)
+ */
+inline void mixeur::configurerGazProfondeur(int8_t pourcent)
+{
+    ajouterRegle(ENTREE_GAZ_RALENTI, SORTIE_PROFONDEUR, pourcent);
+}
+
+/**
+ * @brief Calculer les sorties à partir des canaux d'une trame
+ *
+ * @param canaux  [In]  Canaux reçus (CANAL_MIN à CANAL_MAX)
+ * @param sorties [Out] Valeur de chaque sortie sur la même échelle que les canaux
+ */
+inline void mixeur::calculer(uint16_t const (&canaux)[NB_CANAUX], uint16_t (&sorties)[NB_SORTIES]) const
+{
+    int16_t entrees[NB_ENTREES];
+    int32_t somme[NB_SORTIES] = { 0 };
+
+    for (uint8_t entree = 0; entree < NB_CANAUX; ++entree)
+    {
+        entrees[entree] = expo(entree, (int16_t)canaux[entree] - CANAL_CENTRE);
+    }
+    entrees[ENTREE_GAZ_RALENTI] = (canaux[CANAL_GAZ] - CANAL_MIN) >> 1;
+
+    for (uint8_t i = 0; i < m_nbRegles; ++i)
+    {
+        regleMixage const & regle = m_regles[i];
+        int16_t valeur = entrees[regle.source];
+        somme[regle.sortie] += (int32_t)valeur * (valeur >= 0 ? regle.poidsPositif : regle.poidsNegatif);
+    }
+
+    for (uint8_t sortie = 0; sortie < NB_SORTIES; ++sortie)
+    {
+        int32_t valeur = (somme[sortie] >> 8) + m_trim[sortie];
+        valeur = valeur < m_min[sortie] ? m_min[sortie] : valeur;
+        valeur = valeur > m_max[sortie] ? m_max[sortie] : valeur;
+        sorties[sortie] = CANAL_CENTRE + valeur;
+    }
+}
+
+/**
+ * @brief Appliquer la courbe expo d'un canal par interpolation dans sa table
+ *
+ * @param entree [In] Indice du canal
+ * @param valeur [In] Valeur du canal par rapport au neutre (-COURSE à COURSE)
+ * @return Valeur après expo, même échelle
+ */
+inline int16_t mixeur::expo(uint8_t entree, int16_t valeur) const
+{
+    static_assert(COURSE + 1 == SEGMENTS_EXPO * 64, "expo : segments de 64 pas de canal");
+
+    uint16_t absolue = valeur < 0 ? -valeur : valeur;
+    uint8_t  segment = absolue >> 6;
+    uint8_t  reste   = absolue & 63;
+
+    int16_t const * table = m_expo[entree];
+    int16_t resultat = segment >= SEGMENTS_EXPO ? table[SEGMENTS_EXPO]
+                                                : table[segment] + (((table[segment + 1] - table[segment]) * reste) >> 6);
+    return valeur < 0 ? -resultat : resultat;
+}
+
+#endif
@@ -0,0 +1,704 @@
+/**
+ * @file motorBank.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `motorBank` pour piloter N moteurs à courant continu à travers des ponts en H.
+ *
+ * Chaque canal est constitué d'une broche PWM et d'une broche de direction. L'état de chaque moteur est
+ * rangé dans des tableaux compacts indexés par moteur, et les phases d'overboost des moteurs sont ordonnées
+ * par un petit ordonnanceur afin que chaque moteur soit relâché à son propre délai.
+ *
+ * Le pont est commandé par ses deux entrées (DRV8833, L9110...) : une seule à l'état haut fait tourner le
+ * moteur, les deux à l'état bas le laissent en roue libre et les deux à l'état haut le freinent en
+ * court-circuitant ses bornes. Entre deux impulsions PWM, le courant du moteur décroît donc soit en roue
+ * libre (décroissance rapide), soit en court-circuit (décroissance lente, vitesse mieux tenue à faible PWM).
+ */
+
+#pragma once
+#ifndef MOTORBANK_h
+#define MOTORBANK_h
+
+#include <EEPROM.h>
+
+#include "common.h"
+#include "pointFixe.h"
+
+/**
+ * @brief Décroissance du courant entre deux impulsions PWM
+ */
+typedef enum : uint8_t
+{
+    DECROISSANCE_MIXTE = 0, ///< Seule la broche PWM est modulée : rapide en avant, lente en arrière
+    DECROISSANCE_RAPIDE,    ///< Roue libre entre deux impulsions, dans les deux sens
+    DECROISSANCE_LENTE      ///< Court-circuit entre deux impulsions, dans les deux sens
+} modeDecroissance;
+
+/**
+ * @brief Calibration de N moteurs telle que stockée en EEPROM
+ *
+ * Les seuils sont indexés par moteur puis par direction (0 arrière, 1 avant).
+ */
+template<uint8_t N>
+struct calibrationMoteurs
+{
+    uint8_t magic;              /// Marqueur de validité de la calibration
+    uint8_t seuil[N][2];        /// PWM de démarrage réel de chaque moteur dans chaque direction
+    uint8_t overBoostDelay[N];  /// Délai d'overdrive de référence de chaque moteur
+    uint8_t check;              /// Somme de contrôle des champs précédents
+};
+
+template<uint8_t N>
+class motorBank
+{
+public:
+    inline motorBank(uint8_t const (&pwmPins)[N], uint8_t const (&directionPins)[N]);
+    inline ~motorBank() {}
+
+
+    inline void vitesseMoteurs(int8_t const (&vitesses)[N]);
+    inline void stopMoteurs();
+    inline void freinerMoteurs(uint8_t duree);
+    inline void relacherFreins();
+
+    inline bool setDecroissance(modeDecroissance mode);
+    inline modeDecroissance decroissance() const { return m_decroissance; }
+    inline void setDureeFrein(uint8_t duree) { m_dureeFrein = duree; }
+    inline uint8_t dureeFrein() const { return m_dureeFrein; }
+
+
+    inline void setRegimeMinimum(uint8_t regimeMinimum);
+    inline void setRegimeMinimum(uint8_t moteur, bool direction, uint8_t regimeMinimum);
+    inline void setOverBoostDelay(uint8_t overBoostDelay);
+    inline void setOverBoostDelay(uint8_t moteur, uint8_t overBoostDelay);
+    inline uint8_t regimeMinimum(uint8_t moteur, bool direction) const { return m_regimeMinimum[moteur][direction]; }
+    inline uint8_t overBoostDelay(uint8_t moteur) const { return m_overBoostDelay[moteur]; }
+
+    inline void calibration();
+    inline bool chargerCalibration(int adresse = EEPROM_CALIBRATION_PONTH);
+    inline void sauverCalibration(int adresse = EEPROM_CALIBRATION_PONTH) const;
+
+protected:
+    inline void speedToPwmDirection(uint8_t moteur, int8_t &vitesse, uint8_t &pwm, bool &direction);
+    inline void computeOverDriveDelay(uint8_t moteur, uint8_t const & pwm, bool direction, uint8_t & delai);
+    inline void applyDrive(uint8_t const (&pwm)[N], uint8_t const (&sortieDirection)[N], bool const (&direction)[N], uint8_t const (&delai)[N]);
+    inline void ecrireDirection(uint8_t moteur, uint8_t valeur);
+    inline void freiner(uint8_t moteur, uint8_t duree);
+
+    inline void preparerVitesse(uint8_t moteur, bool direction);
+    inline void preparerBoost(uint8_t moteur, bool direction);
+    inline uint8_t chercherSeuil(uint8_t moteur, bool direction);
+    static inline uint8_t computeCheck(calibrationMoteurs<N> const & calib);
+
+
+protected:
+    uint8_t m_pwmPin[N];             /// Broches PWM des moteurs
+    uint8_t m_directionPin[N];       /// Broches de direction des moteurs
+    uint8_t m_regimeMinimum[N][2];   /// Vitesse minimum autre que 0 par moteur et par direction. Exprimer en ratio PWM entre 0 et 255. Par défault 127.
+    uint8_t m_overBoostDelay[N];     /// Délai d'overdrive de référence de chaque moteur quand il est à sont régime minimum
+    echelle m_echelleVitesse[N][2];  /// Conversion vitesse (1 à 100) vers PWM de chaque moteur et direction
+    echelle m_echelleBoost[N][2];    /// Décroissance du délai d'overdrive pour chaque moteur et direction
+    uint8_t m_pwmOld[N];             /// Dernier PWM appliqué à chaque moteur
+    uint8_t m_directionOld;          /// Dernière direction de chaque moteur, un bit par moteur
+    uint8_t m_directionPwm;          /// Broches de direction capables de PWM, un bit par moteur
+    modeDecroissance m_decroissance; /// Décroissance du courant entre deux impulsions
+    uint8_t m_dureeFrein;            /// Durée du frein actif quand un moteur s'arrête (ms), 0 pour la roue libre
+    uint8_t m_freins;                /// Moteurs en cours de freinage, un bit par moteur
+    unsigned long m_finFrein[N];     /// Fin du freinage de chaque moteur (ms)
+};
+
+
+
+
+
+
+
+// ////////////////////////////////////////////////////////////////////////////
+// ////////////////////////////////////////////////////////////////////////////
+// //////////////////// Constructeurs et destructeurs /////////////////////////
+// ////////////////////////////////////////////////////////////////////////////
+// ////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Constructeur de la classe motorBank
+ *
+ * Ce constructeur initialise les broches PWM et de direction de chaque moteur.
+ *
+ * @param pwmPins       Broches PWM des moteurs
+ * @param directionPins Broches de direction des moteurs
+ */
+template<uint8_t N>
+inline motorBank<N>::motorBank(uint8_t const (&pwmPins)[N], uint8_t const (&directionPins)[N])
+{
+    static_assert(N <= 8, "motorBank : au plus 8 moteurs (directions rangées sur un octet)");
+
+    memset(m_regimeMinimum, 0, sizeof(m_regimeMinimum));
+    setRegimeMinimum(127);
+    setOverBoostDelay(100);
+    m_directionOld = 0;
+    m_directionPwm = 0;
+    m_decroissance = DECROISSANCE_MIXTE;
+    m_dureeFrein = 0;
+    m_freins = 0;
+
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        m_pwmPin[moteur] = pwmPins[moteur];
+        m_directionPin[moteur] = directionPins[moteur];
+        m_pwmOld[moteur] = 0;
+        m_finFrein[moteur] = 0;
+        if (digitalPinToTimer(m_directionPin[moteur]) != NOT_ON_TIMER) m_directionPwm |= 1 << moteur;
+
+        pinMode(m_pwmPin[moteur], OUTPUT);
+        pinMode(m_directionPin[moteur], OUTPUT);
+    }
+}
+
+
+
+
+// ////////////////////////////////////////////////////////////////////////////
+// ////////////////////////////////////////////////////////////////////////////
+// ///////////////////////// Fonctions publiques //////////////////////////////
+// ////////////////////////////////////////////////////////////////////////////
+// ////////////////////////////////////////////////////////////////////////////
+
+
+/**
+* @brief Définir le régime minimum de tous les moteurs
+*
+* @param regimeMinimum [In] Valeur du régime minimum (comprise entre 0 et 255)
+*/
+template<uint8_t N>
+inline void motorBank<N>::setRegimeMinimum(uint8_t regimeMinimum)
+{
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        setRegimeMinimum(moteur, false, regimeMinimum);
+        setRegimeMinimum(moteur, true, regimeMinimum);
+    }
+}
+
+/**
+* @brief Définir le régime minimum d'un moteur dans une direction
+*
+* Cette fonction définit le seuil de démarrage d'un seul moteur pour une direction et reconstruit
+* l'échelle de conversion vitesse vers PWM correspondante si le seuil a changé.
+*
+* @param moteur        [In] Indice du moteur
+* @param direction     [In] Direction concernée (true pour avancer, false pour reculer)
+* @param regimeMinimum [In] Valeur du régime minimum (comprise entre 0 et 255)
+*/
+template<uint8_t N>
+inline void motorBank<N>::setRegimeMinimum(uint8_t moteur, bool direction, uint8_t regimeMinimum)
+{
+    if (m_regimeMinimum[moteur][direction] == regimeMinimum) return;
+
+    m_regimeMinimum[moteur][direction] = regimeMinimum;
+    preparerVitesse(moteur, direction);
+    preparerBoost(moteur, direction);
+}
+
+/**
+* @brief Définir le délai d'overboost de tous les moteurs
+*
+* Ce délai est appliqué lors d'un démarrage ou d'un changement de sens pour vaincre l'inertie du moteur.
+*
+* @param overBoostDelay [In] Délai d'overboost en millisecondes
+*/
+template<uint8_t N>
+inline void motorBank<N>::setOverBoostDelay(uint8_t overBoostDelay)
+{
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        setOverBoostDelay(moteur, overBoostDelay);
+    }
+}
+
+/**
+* @brief Définir le délai d'overboost d'un moteur
+*
+* @param moteur         [In] Indice du moteur
+* @param overBoostDelay [In] Délai d'overboost en millisecondes
+*/
+template<uint8_t N>
+inline void motorBank<N>::setOverBoostDelay(uint8_t moteur, uint8_t overBoostDelay)
+{
+    m_overBoostDelay[moteur] = overBoostDelay;
+    preparerBoost(moteur, false);
+    preparerBoost(moteur, true);
+}
+
+/**
+ * @brief Définir la vitesse des moteurs
+ *
+ * Les valeurs de vitesse doivent être comprises entre -100 et 100 (-100 pour la vitesse maximale en arrière,
+ * 0 pour à l'arrêt, 100 pour la vitesse maximale en avant).
+ *
+ * @param vitesses [In] Vitesse de chaque moteur
+ */
+template<uint8_t N>
+inline void motorBank<N>::vitesseMoteurs(int8_t const (&vitesses)[N])
+{
+    uint8_t pwm[N];
+    uint8_t sortieDirection[N];
+    bool    direction[N];
+    uint8_t delai[N];
+
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        int8_t vitesse = vitesses[moteur];
+
+        speedToPwmDirection(moteur, vitesse, pwm[moteur], direction[moteur]);
+        computeOverDriveDelay(moteur, pwm[moteur], direction[moteur], delai[moteur]);
+
+        // Un moteur qui s'arrête est freiné pendant m_dureeFrein ms, un moteur relancé est libéré de son frein
+        if (pwm[moteur] == 0)
+        {
+            if (m_pwmOld[moteur] != 0 && m_dureeFrein) freiner(moteur, m_dureeFrein);
+        }
+        else if (m_freins)
+        {
+            m_freins &= ~(1 << moteur);
+        }
+
+        m_pwmOld[moteur] = pwm[moteur];
+        m_directionOld = direction[moteur] ? (m_directionOld | (1 << moteur)) : (m_directionOld & ~(1 << moteur));
+
+        if (pwm[moteur] == 0)
+        {
+            bool frein = m_freins & (1 << moteur);
+            pwm[moteur] = frein ? 255 : 0;
+            sortieDirection[moteur] = frein ? 255 : 0;
+        }
+        else if (direction[moteur] && m_decroissance == DECROISSANCE_LENTE)
+        {
+            sortieDirection[moteur] = 255 - pwm[moteur];
+            pwm[moteur] = 255;
+        }
+        else if (!direction[moteur] && m_decroissance == DECROISSANCE_RAPIDE)
+        {
+            sortieDirection[moteur] = pwm[moteur];
+            pwm[moteur] = 0;
+        }
+        else
+        {
+            sortieDirection[moteur] = direction[moteur] ? 0 : 255;
+            pwm[moteur] = direction[moteur] ? pwm[moteur] : 255 - pwm[moteur];
+        }
+    }
+
+    applyDrive(pwm, sortieDirection, direction, delai);
+}
+
+/**
+* @brief Arrêter les moteurs
+*
+* Cette fonction arrête tous les moteurs en mettant les broches PWM à LOW et les broches de direction à LOW.
+*/
+template<uint8_t N>
+inline void motorBank<N>::stopMoteurs()
+{
+    debugln(F("Arrét du bateau"));
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        digitalWrite(m_pwmPin[moteur], LOW);
+        digitalWrite(m_directionPin[moteur], LOW);
+    }
+    m_freins = 0;
+}
+
+/**
+* @brief Freiner tous les moteurs, puis les laisser en roue libre
+*
+* Les deux entrées de chaque pont passent à l'état haut : le moteur est court-circuité et s'arrête bien plus
+* vite qu'en roue libre. Le frein est relâché par `relacherFreins()` au bout de sa durée, pour ne pas
+* tenir le court-circuit indéfiniment ; l'appel ne bloque pas.
+*
+* @param duree [In] Durée du freinage en millisecondes, 0 pour un arrêt en roue libre comme `stopMoteurs()`
+*/
+template<uint8_t N>
+inline void motorBank<N>::freinerMoteurs(uint8_t duree)
+{
+    if (!duree)
+    {
+        stopMoteurs();
+        return;
+    }
+
+    debugln(F("Freinage du bateau"));
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        freiner(moteur, duree);
+        m_pwmOld[moteur] = 0;
+        ecrireDirection(moteur, 255);
+        analogWrite(m_pwmPin[moteur], 255);
+    }
+}
+
+/**
+* @brief Passer en roue libre les moteurs dont le freinage est terminé
+*
+* À appeler régulièrement, plus souvent que la durée du frein (à chaque cycle de pilotage par exemple).
+*/
+template<uint8_t N>
+inline void motorBank<N>::relacherFreins()
+{
+    if (!m_freins) return;
+
+    unsigned long maintenant = millis();
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        if (!(m_freins & (1 << moteur)) || (long)(maintenant - m_finFrein[moteur]) < 0) continue;
+
+        m_freins &= ~(1 << moteur);
+        digitalWrite(m_pwmPin[moteur], LOW);
+        digitalWrite(m_directionPin[moteur], LOW);
+    }
+}
+
+/**
+* @brief Choisir la décroissance du courant entre deux impulsions PWM
+*
+* Les décroissances rapide et lente dans les deux sens demandent de moduler aussi la broche de direction.
+* Elles sont refusées si une seule broche de direction n'est pas une sortie PWM, pour que tous les moteurs
+* gardent la même réponse.
+*
+* @param mode [In] Décroissance voulue
+* @return true si la décroissance est appliquée, false si les broches ne le permettent pas (mode inchangé)
+*/
+template<uint8_t N>
+inline bool motorBank<N>::setDecroissance(modeDecroissance mode)
+{
+    uint8_t tous = (uint8_t)((1u << N) - 1);
+    if (mode != DECROISSANCE_MIXTE && (m_directionPwm & tous) != tous) return false;
+
+    m_decroissance = mode;
+    return true;
+}
+
+/**
+ * @brief Calibrer les seuils de démarrage des moteurs
+ *
+ * Pour chaque moteur et chaque direction, le PWM est augmenté progressivement à partir de 0. L'opérateur
+ * envoie un caractère sur le port série dès que l'hélice se met à tourner : le PWM courant devient le
+ * régime minimum de ce moteur dans cette direction. Les échelles de conversion sont recalculées au fur et à mesure.
+ * Une rampe allée jusqu'à 255 sans réponse est rejetée : le seuil précédent est conservé.
+ */
+template<uint8_t N>
+inline void motorBank<N>::calibration()
+{
+    Serial.println(F("Calibration : envoyer un caractere des que l'helice tourne"));
+
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        for (uint8_t sens = 0; sens < 2; ++sens)
+        {
+            bool direction = sens == 0;
+            uint8_t seuil = chercherSeuil(moteur, direction);
+            if (seuil)
+            {
+                setRegimeMinimum(moteur, direction, seuil);
+            }
+            else
+            {
+                Serial.print(F("Seuil rejete, conserve : "));
+                Serial.println(m_regimeMinimum[moteur][direction]);
+            }
+        }
+    }
+
+    Serial.println(F("Calibration terminee"));
+}
+
+/**
+ * @brief Charger la calibration depuis l'EEPROM
+ *
+ * La calibration n'est appliquée que si elle porte le bon marqueur et une somme de contrôle valide.
+ *
+ * @param adresse [In] Adresse de la calibration dans l'EEPROM
+ * @return true si une calibration valide a été chargée, false sinon (les valeurs par défaut sont conservées)
+ */
+template<uint8_t N>
+inline bool motorBank<N>::chargerCalibration(int adresse)
+{
+    calibrationMoteurs<N> calib;
+    EEPROM.get(adresse, calib);
+
+    if (calib.magic != EEPROM_MAGIC || calib.check != computeCheck(calib))
+    {
+        debugln(F("Pas de calibration en EEPROM"));
+        return false;
+    }
+
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        setRegimeMinimum(moteur, false, calib.seuil[moteur][0]);
+        setRegimeMinimum(moteur, true,  calib.seuil[moteur][1]);
+        setOverBoostDelay(moteur, calib.overBoostDelay[moteur]);
+    }
+    return true;
+}
+
+/**
+ * @brief Sauvegarder la calibration courante en EEPROM
+ *
+ * Seuls les octets modifiés sont réécrits pour ménager l'EEPROM.
+ *
+ * @param adresse [In] Adresse de la calibration dans l'EEPROM
+ */
+template<uint8_t N>
+inline void motorBank<N>::sauverCalibration(int adresse) const
+{
+    calibrationMoteurs<N> calib;
+    calib.magic = EEPROM_MAGIC;
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        calib.seuil[moteur][0] = m_regimeMinimum[moteur][0];
+        calib.seuil[moteur][1] = m_regimeMinimum[moteur][1];
+        calib.overBoostDelay[moteur] = m_overBoostDelay[moteur];
+    }
+    calib.check = computeCheck(calib);
+    EEPROM.put(adresse, calib);
+}
+
+
+
+// ////////////////////////////////////////////////////////////////////////////
+// ////////////////////////////////////////////////////////////////////////////
+// ///////////////////////// Fonctions privés ////////////////////////////////
+// ////////////////////////////////////////////////////////////////////////////
+// ////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Calculer la configuration d'un moteur en fonction de sa vitesse
+ *
+ * Cette fonction interne calcule la configuration d'un moteur en fonction de la valeur de vitesse fournie.
+ * Le PWM est calculé par l'échelle du moteur pour la direction demandée, sans division.
+ *
+ * @param moteur    [in]      Indice du moteur
+ * @param vitesse   [in, out] Vitesse du moteur (-100 pour la vitesse maximale en arrière, 0 pour à l'arrêt, 100 pour la vitesse maximale en avant)
+ * @param pwm       [out]     Valeur à écrire sur la broche PWM du moteur
+ * @param direction [out]     Direction du moteur (true pour avancer, false pour reculer)
+ */
+template<uint8_t N>
+inline void motorBank<N>::speedToPwmDirection(uint8_t moteur, int8_t &vitesse, uint8_t &pwm, bool &direction)
+{
+    if (vitesse > +100) vitesse = +100;
+    if (vitesse < -100) vitesse = -100;
+
+    direction = vitesse >= 0;
+    int8_t vitesseAbs = abs(vitesse);
+
+    if (vitesseAbs)
+    {
+        pwm = m_echelleVitesse[moteur][direction](vitesseAbs);
+    }
+    else
+    {
+        pwm = 0;
+    }
+}
+
+/**
+ * @brief Calculer le délai d'overdrive pour un moteur
+ *
+ * Un délai n'est appliqué que lorsque le moteur démarre ou change de sens. Il décroît linéairement
+ * du délai de référence (au régime minimum) jusqu'à 0 (au double du régime minimum).
+ *
+ * @param moteur    [In]  Indice du moteur
+ * @param pwm       [In]  Vitesse du moteur
+ * @param direction [In]  Direction du moteur (true pour avancer, false pour reculer)
+ * @param delai     [Out] Variable dans laquelle stocker le délai d'overdrive calculé
+ */
+template<uint8_t N>
+inline void motorBank<N>::computeOverDriveDelay(uint8_t moteur, uint8_t const & pwm, bool direction, uint8_t & delai)
+{
+    delai = 0;
+
+    if(pwm)
+    {
+        bool directionOld = m_directionOld & (1 << moteur);
+
+        if(directionOld != direction || m_pwmOld[moteur] == 0)
+        {
+            uint8_t regimeMinimum = m_regimeMinimum[moteur][direction];
+            uint8_t pwmDiff = pwm - regimeMinimum;
+            long delaiBrut = m_echelleBoost[moteur][direction](pwmDiff);
+            delai = delaiBrut > 0 ? delaiBrut : 0; // au-delà de deux fois le régime minimum, pas d'overdrive
+        }
+    }
+}
+
+/**
+ * @brief Appliquer la configuration des moteurs aux broches
+ *
+ * Les moteurs dont le délai d'overdrive est nul reçoivent directement leur PWM. Les autres sont lancés à
+ * pleine puissance puis relâchés dans l'ordre croissant de leur délai, chacun au bout de son propre délai.
+ *
+ * @param pwm             [In] Valeur à écrire sur la broche PWM de chaque moteur
+ * @param sortieDirection [In] Valeur à écrire sur la broche de direction de chaque moteur (0 ou 255 sans PWM)
+ * @param direction       [In] Direction de chaque moteur (true pour avancer, false pour reculer)
+ * @param delai           [In] Délai d'overdrive calculé pour chaque moteur
+ */
+template<uint8_t N>
+inline void motorBank<N>::applyDrive(uint8_t const (&pwm)[N], uint8_t const (&sortieDirection)[N], bool const (&direction)[N], uint8_t const (&delai)[N])
+{
+    uint8_t ordre[N];
+    uint8_t nbBoost = 0;
+
+    for (uint8_t moteur = 0; moteur < N; ++moteur)
+    {
+        if (delai[moteur] == 0)
+        {
+            ecrireDirection(moteur, sortieDirection[moteur]);
+            analogWrite(m_pwmPin[moteur], pwm[moteur]);
+            continue;
+        }
+
+        ecrireDirection(moteur, direction[moteur] ? 0 : 255);
+        analogWrite(m_pwmPin[moteur], direction[moteur] ? 255 : 0);
+
+        // Insertion triée par délai croissant
+        uint8_t i = nbBoost++;
+        while (i > 0 && delai[ordre[i - 1]] > delai[moteur])
+        {
+            ordre[i] = ordre[i - 1];
+            --i;
+        }
+        ordre[i] = moteur;
+    }
+
+    uint8_t ecoule = 0;
+    for (uint8_t i = 0; i < nbBoost; ++i)
+    {
+        uint8_t moteur = ordre[i];
+
+        delay(delai[moteur] - ecoule);
+        ecoule = delai[moteur];
+
+        ecrireDirection(moteur, sortieDirection[moteur]);
+        analogWrite(m_pwmPin[moteur], pwm[moteur]);
+    }
+}
+
+/**
+ * @brief Écrire la broche de direction d'un moteur, en PWM seulement entre les deux états
+ */
+template<uint8_t N>
+inline void motorBank<N>::ecrireDirection(uint8_t moteur, uint8_t valeur)
+{
+    if (valeur == 0 || valeur == 255)
+    {
+        digitalWrite(m_directionPin[moteur], valeur ? HIGH : LOW);
+    }
+    else
+    {
+        analogWrite(m_directionPin[moteur], valeur);
+    }
+}
+
+/**
+ * @brief Marquer un moteur en freinage pendant une durée, sans toucher aux broches
+ *
+ * @param moteur [In] Indice du moteur
+ * @param duree  [In] Durée du freinage en millisecondes
+ */
+template<uint8_t N>
+inline void motorBank<N>::freiner(uint8_t moteur, uint8_t duree)
+{
+    m_freins |= 1 << moteur;
+    m_finFrein[moteur] = millis() + duree;
+}
+
+/**
+ * @brief Préparer l'échelle de conversion vitesse vers PWM d'un moteur dans une direction
+ *
+ * Équivalent à `map(vitesse, 0, 100, regimeMinimum, 255)`. L'échelle tient en quelques octets par moteur et
+ * par direction, là où une table de 100 PWM en coûterait 400 en RAM pour deux moteurs.
+ *
+ * @param moteur    [In] Indice du moteur
+ * @param direction [In] Direction concernée (true pour avancer, false pour reculer)
+ */
+template<uint8_t N>
+inline void motorBank<N>::preparerVitesse(uint8_t moteur, bool direction)
+{
+    m_echelleVitesse[moteur][direction] = echelle(0, 100, m_regimeMinimum[moteur][direction], 255);
+}
+
+/**
+ * @brief Préparer l'échelle du délai d'overdrive d'un moteur dans une direction
+ *
+ * Équivalent à `map(pwmDiff, regimeMinimum, 0, 0, overBoostDelay)`, la division étant faite ici une fois
+ * pour toutes plutôt qu'à chaque démarrage du moteur.
+ *
+ * @param moteur    [In] Indice du moteur
+ * @param direction [In] Direction concernée (true pour avancer, false pour reculer)
+ */
+template<uint8_t N>
+inline void motorBank<N>::preparerBoost(uint8_t moteur, bool direction)
+{
+    m_echelleBoost[moteur][direction] = echelle(m_regimeMinimum[moteur][direction], 0, 0, m_overBoostDelay[moteur]);
+}
+
+/**
+ * @brief Chercher le seuil de démarrage d'un moteur
+ *
+ * Le PWM est augmenté d'un cran toutes les 30ms jusqu'à ce qu'un caractère soit reçu sur le port série.
+ * Les caractères reçus pendant la pause qui précède la rampe sont ignorés. Le moteur est arrêté avant de
+ * rendre la main.
+ *
+ * @param moteur    [In] Indice du moteur
+ * @param direction [In] Direction testée (true pour avancer, false pour reculer)
+ * @return Le PWM auquel l'opérateur a vu le moteur démarrer, 0 si la rampe est allée au bout sans réponse
+ *         (255 rendrait toute vitesse non nulle égale à la pleine puissance)
+ */
+template<uint8_t N>
+inline uint8_t motorBank<N>::chercherSeuil(uint8_t moteur, bool direction)
+{
+    uint8_t pwm = 0;
+
+    Serial.print(F("Moteur "));
+    Serial.print(moteur);
+    Serial.println(direction ? F(" avant") : F(" arriere"));
+
+    delay(1000);
+    while (Serial.available()) Serial.read();
+
+    digitalWrite(m_directionPin[moteur], !direction);
+    while (!Serial.available() && pwm < 255)
+    {
+        ++pwm;
+        analogWrite(m_pwmPin[moteur], direction ? pwm : 255 - pwm);
+        delay(30);
+    }
+    bool repondu = Serial.available();
+    while (Serial.available()) Serial.read();
+
+    digitalWrite(m_pwmPin[moteur], LOW);
+    digitalWrite(m_directionPin[moteur], LOW);
+
+    Serial.print(F("Seuil = "));
+    Serial.println(pwm);
+    return repondu && pwm < 255 ? pwm : 0;
+}
+
+/**
+ * @brief Calculer la somme de contrôle d'une calibration
+ *
+ * @param calib [In] Calibration dont on veut la somme de contrôle
+ * @return Le ou exclusif de tous les octets précédant le champ `check`
+ */
+template<uint8_t N>
+inline uint8_t motorBank<N>::computeCheck(calibrationMoteurs<N> const & calib)
+{
+    uint8_t const * octets = reinterpret_cast<uint8_t const *>(&calib);
+    uint8_t check = 0;
+    for (uint8_t i = 0; i < sizeof(calib) - 1; ++i)
+    {
+        check ^= octets[i];
+    }
+    return check;
+}
+
+
+#endif
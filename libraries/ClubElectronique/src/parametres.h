@@ -0,0 +1,213 @@
+/**
+ * @file parametres.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit le registre des paramètres réglables en direct depuis la console série de la télécommande.
+ *
+ * Chaque paramètre a un identifiant commun au bateau et à la télécommande, une plage de valeurs et une
+ * valeur par défaut, tous sur un octet. Les paramètres du bateau voyagent dans un message radio dont la
+ * commande porte le drapeau `PARAM` : `gauche` contient alors l'identifiant et `droit` la valeur.
+ */
+
+#pragma once
+#ifndef PARAMETRES_h
+#define PARAMETRES_h
+
+#include "Arduino.h"
+#include <EEPROM.h>
+
+#include "common.h"
+
+/**
+ * @brief Identifiants des paramètres
+ */
+typedef enum : uint8_t
+{
+    PARAM_REGIME_GAUCHE_ARRIERE = 0, ///< Régime minimum du moteur gauche en arrière (PWM)
+    PARAM_REGIME_GAUCHE_AVANT,       ///< Régime minimum du moteur gauche en avant (PWM)
+    PARAM_REGIME_DROIT_ARRIERE,      ///< Régime minimum du moteur droit en arrière (PWM)
+    PARAM_REGIME_DROIT_AVANT,        ///< Régime minimum du moteur droit en avant (PWM)
+    PARAM_OVERBOOST_GAUCHE,          ///< Délai d'overboost du moteur gauche (ms)
+    PARAM_OVERBOOST_DROIT,           ///< Délai d'overboost du moteur droit (ms)
+    PARAM_ANGLE_SEUIL,               ///< Angle de seuil de l'algorithme lisse de la télécommande (degrés)
+    NB_PARAMETRES
+} idParametre;
+
+/**
+ * @brief Plage, valeur par défaut et emplacement d'un paramètre
+ */
+typedef struct
+{
+    uint8_t min;     ///< Valeur minimale
+    uint8_t max;     ///< Valeur maximale
+    uint8_t defaut;  ///< Valeur par défaut
+    bool    bateau;  ///< Le paramètre est appliqué par le bateau (sinon par la télécommande)
+} descriptionParametre;
+
+static const descriptionParametre DESCRIPTIONS_PARAMETRES[NB_PARAMETRES] =
+{
+    {   0, 255, 127, true  }, // PARAM_REGIME_GAUCHE_ARRIERE
+    {   0, 255, 127, true  }, // PARAM_REGIME_GAUCHE_AVANT
+    {   0, 255, 127, true  }, // PARAM_REGIME_DROIT_ARRIERE
+    {   0, 255, 127, true  }, // PARAM_REGIME_DROIT_AVANT
+    {   0, 255, 100, true  }, // PARAM_OVERBOOST_GAUCHE
+    {   0, 255, 100, true  }, // PARAM_OVERBOOST_DROIT
+    {   1,  89,  45, false }, // PARAM_ANGLE_SEUIL
+};
+
+/**
+ * @brief Valeurs des paramètres telles que stockées en EEPROM
+ */
+typedef struct
+{
+    uint8_t magic;                  ///< Marqueur de validité
+    uint8_t valeurs[NB_PARAMETRES]; ///< Valeur de chaque paramètre
+    uint8_t check;                  ///< Somme de contrôle (XOR des valeurs)
+} sauvegardeParametres;
+
+class registreParametres
+{
+public:
+    inline registreParametres();
+
+    inline bool ecrire(uint8_t id, uint8_t valeur);
+    inline uint8_t lire(uint8_t id) const { return m_valeurs[id]; }
+    static inline bool existe(uint8_t id) { return id < NB_PARAMETRES; }
+    static inline descriptionParametre const & description(uint8_t id) { return DESCRIPTIONS_PARAMETRES[id]; }
+
+    inline bool charger(int adresse = EEPROM_PARAMETRES);
+    inline void sauver(int adresse = EEPROM_PARAMETRES) const;
+
+    inline void afficher(Print & sortie) const;
+    static inline void afficherNom(Print & sortie, uint8_t id);
+
+private:
+    static inline uint8_t computeCheck(sauvegardeParametres const & sauvegarde);
+
+private:
+    uint8_t m_valeurs[NB_PARAMETRES]; ///< Valeur courante de chaque paramètre
+};
+
+
+
+/**
+ * @brief Constructeur : tous les paramètres prennent leur valeur par défaut
+ */
+inline registreParametres::registreParametres()
+{
+    for (uint8_t id = 0; id < NB_PARAMETRES; ++id)
+    {
+        m_valeurs[id] = DESCRIPTIONS_PARAMETRES[id].defaut;
+    }
+}
+
+/**
+ * @brief Modifier un paramètre
+ *
+ * @param id     [In] Identifiant du paramètre
+ * @param valeur [In] Nouvelle valeur
+ * @return false si le paramètre n'existe pas ou si la valeur sort de sa plage (rien n'est modifié)
+ */
+inline bool registreParametres::ecrire(uint8_t id, uint8_t valeur)
+{
+    if (!existe(id)) return false;
+    if (valeur < DESCRIPTIONS_PARAMETRES[id].min || valeur > DESCRIPTIONS_PARAMETRES[id].max) return false;
+
+    m_valeurs[id] = valeur;
+    return true;
+}
+
+/**
+ * @brief Charger les paramètres depuis l'EEPROM
+ *
+ * @param adresse [In] Adresse des paramètres dans l'EEPROM
+ * @return true si une sauvegarde valide a été chargée, false sinon (les valeurs courantes sont conservées)
+ */
+inline bool registreParametres::charger(int adresse)
+{
+    sauvegardeParametres sauvegarde;
+    EEPROM.get(adresse, sauvegarde);
+
+    if (sauvegarde.magic != EEPROM_MAGIC || sauvegarde.check != computeCheck(sauvegarde))
+    {
+        debugln(F("Pas de parametres en EEPROM"));
+        return false;
+    }
+
+    for (uint8_t id = 0; id < NB_PARAMETRES; ++id)
+    {
+        ecrire(id, sauvegarde.valeurs[id]);
+    }
+    return true;
+}
+
+/**
+ * @brief Sauvegarder les paramètres en EEPROM (seuls les octets modifiés sont réécrits)
+ *
+ * @param adresse [In] Adresse des paramètres dans l'EEPROM
+ */
+inline void registreParametres::sauver(int adresse) const
+{
+    sauvegardeParametres sauvegarde;
+    sauvegarde.magic = EEPROM_MAGIC;
+    for (uint8_t id = 0; id < NB_PARAMETRES; ++id)
+    {
+        sauvegarde.valeurs[id] = m_valeurs[id];
+    }
+    sauvegarde.check = computeCheck(sauvegarde);
+    EEPROM.put(adresse, sauvegarde);
+}
+
+/**
+ * @brief Afficher tous les paramètres : identifiant, nom, valeur, plage et emplacement
+ */
+inline void registreParametres::afficher(Print & sortie) const
+{
+    for (uint8_t id = 0; id < NB_PARAMETRES; ++id)
+    {
+        sortie.print(id);
+        sortie.print(' ');
+        afficherNom(sortie, id);
+        sortie.print(F(" = "));
+        sortie.print(m_valeurs[id]);
+        sortie.print(F(" ["));
+        sortie.print(DESCRIPTIONS_PARAMETRES[id].min);
+        sortie.print(F(".."));
+        sortie.print(DESCRIPTIONS_PARAMETRES[id].max);
+        sortie.print(DESCRIPTIONS_PARAMETRES[id].bateau ? F("] bateau") : F("] telecommande"));
+        sortie.println();
+    }
+}
+
+/**
+ * @brief Afficher le nom d'un paramètre
+ */
+inline void registreParametres::afficherNom(Print & sortie, uint8_t id)
+{
+    switch (id)
+    {
+    case PARAM_REGIME_GAUCHE_ARRIERE: sortie.print(F("regimeGaucheArriere")); break;
+    case PARAM_REGIME_GAUCHE_AVANT:   sortie.print(F("regimeGaucheAvant"));   break;
+    case PARAM_REGIME_DROIT_ARRIERE:  sortie.print(F("regimeDroitArriere"));  break;
+    case PARAM_REGIME_DROIT_AVANT:    sortie.print(F("regimeDroitAvant"));    break;
+    case PARAM_OVERBOOST_GAUCHE:      sortie.print(F("overBoostGauche"));     break;
+    case PARAM_OVERBOOST_DROIT:       sortie.print(F("overBoostDroit"));      break;
+    case PARAM_ANGLE_SEUIL:           sortie.print(F("angleSeuil"));          break;
+    default:                          sortie.print(F("?"));                   break;
+    }
+}
+
+/**
+ * @brief Calculer la somme de contrôle d'une sauvegarde
+ */
+inline uint8_t registreParametres::computeCheck(sauvegardeParametres const & sauvegarde)
+{
+    uint8_t check = sauvegarde.magic;
+    for (uint8_t id = 0; id < NB_PARAMETRES; ++id)
+    {
+        check ^= sauvegarde.valeurs[id];
+    }
+    return check;
+}
+
+#endif
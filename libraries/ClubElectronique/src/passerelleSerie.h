@@ -0,0 +1,193 @@
+/**
+ * @file passerelleSerie.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `passerelle` qui laisse un PC piloter le bateau à travers la télécommande.
+ *
+ * Le PC envoie des paquets de commande sur le port série, protégés par un CRC-8 et délimités par le codage
+ * COBS. La télécommande ne garde que le dernier paquet reçu et l'émet à sa propre cadence ; après chaque
+ * émission, elle renvoie au PC un paquet de télémétrie avec ses compteurs de réception et d'acquittement.
+ * Les paquets sont rangés sans bourrage, entiers de poids faible en premier, comme sur l'ATmega et sur PC.
+ */
+
+#pragma once
+#ifndef PASSERELLESERIE_h
+#define PASSERELLESERIE_h
+
+#include "Arduino.h"
+#include "cobs.h"
+#include "radioMessage.h"
+#include "trameCanaux.h"
+
+#define PASSERELLE_BAUD           500000 ///< Débit du port série en mode passerelle (exact à 16MHz)
+#define PASSERELLE_DELAI_COMMANDE 500    ///< Age au-delà duquel une commande du PC n'est plus émise (ms)
+
+/**
+ * @brief Types de paquets
+ */
+typedef enum : uint8_t
+{
+    PAQUET_COMMANDE = 1,  ///< PC vers télécommande
+    PAQUET_TELEMETRIE = 2 ///< Télécommande vers PC
+} typePaquet;
+
+/**
+ * @brief Commande envoyée par le PC
+ */
+typedef struct __attribute__((packed))
+{
+    uint8_t  type;    ///< PAQUET_COMMANDE
+    uint16_t numero;  ///< Numéro choisi par le PC, renvoyé dans la télémétrie une fois la commande émise
+    int8_t   gauche;  ///< Vitesse du moteur gauche (-100 à 100)
+    int8_t   droit;   ///< Vitesse du moteur droit (-100 à 100)
+    uint8_t  cmd;     ///< Bits de commande radio (radioCmd)
+} paquetCommande;
+
+/**
+ * @brief Compte rendu envoyé au PC après chaque émission radio
+ */
+typedef struct __attribute__((packed))
+{
+    uint8_t  type;         ///< PAQUET_TELEMETRIE
+    uint16_t numero;       ///< Numéro de la dernière commande du PC émise
+    uint16_t nbRecus;      ///< Paquets de commande valides reçus
+    uint16_t nbRejetes;    ///< Trames reçues rejetées (COBS tronqué ou trop long, taille, type ou CRC)
+    uint16_t nbRemplaces;  ///< Commandes remplacées par une plus récente avant d'avoir été émises
+    uint16_t nbEmis;       ///< Commandes du PC émises par la radio
+    uint16_t nbAcquittes;  ///< Commandes du PC acquittées par le bateau
+} paquetTelemetrie;
+
+/**
+ * @brief Ajouter le CRC-8 à un paquet puis le coder en COBS
+ *
+ * @param paquet [In]  Paquet à envoyer
+ * @param codee  [Out] Trame à écrire sur le port série
+ * @return Nombre d'octets de la trame
+ */
+template<typename Paquet>
+inline uint8_t encoderPaquet(Paquet const & paquet, uint8_t (&codee)[COBS_TAILLE_CODEE(sizeof(Paquet) + 1)])
+{
+    uint8_t brut[sizeof(Paquet) + 1];
+    memcpy(brut, &paquet, sizeof(Paquet));
+    brut[sizeof(Paquet)] = crc8(brut, sizeof(Paquet));
+    return encoderCobs(brut, sizeof(brut), codee);
+}
+
+/**
+ * @brief Vérifier une trame décodée et en extraire un paquet
+ *
+ * @param trame  [In]  Trame décodée
+ * @param taille [In]  Taille de la trame
+ * @param type   [In]  Type de paquet attendu
+ * @param paquet [Out] Paquet, rempli seulement si la trame est valide
+ * @return true si la trame a la bonne taille, le bon type et un CRC correct
+ */
+template<typename Paquet>
+inline bool decoderPaquet(uint8_t const * trame, uint8_t taille, typePaquet type, Paquet & paquet)
+{
+    if (taille != sizeof(Paquet) + 1 || trame[0] != type || trame[sizeof(Paquet)] != crc8(trame, sizeof(Paquet)))
+    {
+        return false;
+    }
+    memcpy(&paquet, trame, sizeof(Paquet));
+    return true;
+}
+
+class passerelle
+{
+public:
+    inline passerelle() : m_recue(false), m_aEmettre(false), m_instant(0), m_telemetrie() { m_telemetrie.type = PAQUET_TELEMETRIE; }
+
+    template<typename Port> inline void recevoir(Port & port, unsigned long maintenant);
+    inline bool commande(radioMessage & msg, unsigned long maintenant);
+    template<typename Port> inline void compteRendu(Port & port, bool emise, bool acquittee);
+
+    inline paquetTelemetrie const & telemetrie() const { return m_telemetrie; }
+
+private:
+    decodeurCobs     m_decodeur;    ///< Trames reçues du PC
+    paquetCommande   m_derniere;    ///< Dernière commande valide reçue
+    bool             m_recue;       ///< Une commande a déjà été reçue
+    bool             m_aEmettre;    ///< La dernière commande n'a pas encore été émise
+    unsigned long    m_instant;     ///< Instant de réception de la dernière commande (ms)
+    paquetTelemetrie m_telemetrie;  ///< Compteurs renvoyés au PC
+};
+
+
+
+/**
+ * @brief Lire tous les octets disponibles sur le port série
+ *
+ * Seule la commande valide la plus récente est conservée. Les trames mal codées, trop longues ou dont la
+ * taille, le type ou le CRC sont faux sont comptées dans `nbRejetes`.
+ *
+ * @param port       [In] Port série (Serial)
+ * @param maintenant [In] Instant présent (ms)
+ */
+template<typename Port>
+inline void passerelle::recevoir(Port & port, unsigned long maintenant)
+{
+    while (port.available())
+    {
+        uint8_t taille = m_decodeur.ajouter(port.read());
+        if (!taille) continue;
+
+        paquetCommande paquet;
+        if (taille == COBS_INVALIDE || !decoderPaquet(m_decodeur.trame(), taille, PAQUET_COMMANDE, paquet))
+        {
+            ++m_telemetrie.nbRejetes;
+            continue;
+        }
+
+        if (m_aEmettre) ++m_telemetrie.nbRemplaces;
+        m_derniere = paquet;
+        m_recue = true;
+        m_aEmettre = true;
+        m_instant = maintenant;
+        ++m_telemetrie.nbRecus;
+    }
+}
+
+/**
+ * @brief Remplacer le contenu du message radio par la dernière commande du PC
+ *
+ * La dernière commande est réémise à chaque appel tant qu'elle a moins de PASSERELLE_DELAI_COMMANDE ms :
+ * au-delà, le PC est considéré comme absent et le message n'est pas modifié.
+ *
+ * @param msg        [In, Out] Message radio à émettre
+ * @param maintenant [In]      Instant présent (ms)
+ * @return true si le message porte une commande du PC
+ */
+inline bool passerelle::commande(radioMessage & msg, unsigned long maintenant)
+{
+    if (!m_recue || maintenant - m_instant > PASSERELLE_DELAI_COMMANDE) return false;
+
+    msg.cmd = m_derniere.cmd;
+    msg.gauche = m_derniere.gauche;
+    msg.droit = m_derniere.droit;
+    m_telemetrie.numero = m_derniere.numero;
+    m_aEmettre = false;
+    return true;
+}
+
+/**
+ * @brief Compter le résultat de l'émission et envoyer la télémétrie au PC
+ *
+ * @param port      [In] Port série (Serial)
+ * @param emise     [In] Le message émis portait une commande du PC
+ * @param acquittee [In] Le bateau a acquitté le message
+ */
+template<typename Port>
+inline void passerelle::compteRendu(Port & port, bool emise, bool acquittee)
+{
+    if (emise)
+    {
+        ++m_telemetrie.nbEmis;
+        if (acquittee) ++m_telemetrie.nbAcquittes;
+    }
+
+    uint8_t codee[COBS_TAILLE_CODEE(sizeof(paquetTelemetrie) + 1)];
+    port.write(codee, encoderPaquet(m_telemetrie, codee));
+}
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file pointFixe.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit des conversions d'échelle entières sans division, aux arrondis identiques à `map()`.
+ *
+ * `map()` fait une multiplication et une division sur 32 bits, et la division coûte plusieurs centaines de
+ * cycles sur l'ATmega. Quand la plage d'entrée est connue d'avance (constante, ou fixée par une calibration),
+ * la division est remplacée par une multiplication par l'inverse du diviseur suivie d'un décalage : pour un
+ * diviseur d < 2^16 et l = ⌈log2 d⌉, m = ⌈2^(16+l) / d⌉ donne exactement ⌊n × m / 2^(16+l)⌋ = ⌊n / d⌋ pour
+ * tout n < 2^16. m tient sur 17 bits : le produit est calculé avec deux multiplications 16 × 16 bits.
+ */
+
+#pragma once
+#ifndef POINTFIXE_h
+#define POINTFIXE_h
+
+#include "Arduino.h"
+
+/**
+ * @brief Plus petit l tel que 2^l >= d
+ */
+constexpr uint8_t log2Superieur(uint16_t d, uint8_t l = 0)
+{
+    return (1ul << l) >= d ? l : log2Superieur(d, l + 1);
+}
+
+/**
+ * @brief Inverse d'un diviseur d sur 16 bits : m = (mHaut << 16 | mBas) et décalage 16 + ⌈log2 d⌉
+ */
+struct reciproque
+{
+    uint16_t mBas;      ///< 16 bits de poids faible de m
+    uint8_t  mHaut;     ///< Bit 16 de m
+    uint8_t  decalage;  ///< Décalage total, entre 16 et 32
+
+    constexpr reciproque(uint16_t d) : reciproque(d, 16 + log2Superieur(d)) {}
+
+private:
+    constexpr reciproque(uint16_t d, uint8_t s) : reciproque(calculerM(d, s), s, 0) {}
+    constexpr reciproque(uint32_t m, uint8_t s, int) : mBas(m), mHaut(m >> 16), decalage(s) {}
+
+    /// m = ⌈2^s / d⌉ = ⌊(2^s - 1) / d⌋ + 1, calculé sur 32 bits
+    static constexpr uint32_t calculerM(uint16_t d, uint8_t s) { return (s == 32 ? 0xFFFFFFFFul : (1ul << s) - 1) / d + 1; }
+};
+
+/**
+ * @brief Diviser n par le diviseur d'une réciproque, sans division
+ *
+ * @param n [In] Dividende
+ * @param r [In] Réciproque du diviseur
+ * @return ⌊n / d⌋
+ */
+inline uint16_t diviser(uint16_t n, reciproque const & r)
+{
+    uint32_t bas = (uint32_t)n * r.mBas;   // 16 x 16 bits
+    uint16_t haut = r.mHaut ? n : 0;       // n x bit 16 de m
+    return ((uint32_t)haut + (bas >> 16)) >> (r.decalage - 16);
+}
+
+/**
+ * @brief Diviser un entier signé, avec la troncature vers zéro de l'opérateur `/`
+ *
+ * @param n [In] Dividende, |n| < 2^15
+ * @param r [In] Réciproque du diviseur (positif)
+ * @return n / d
+ */
+inline int16_t diviserSigne(int32_t n, reciproque const & r)
+{
+    return n < 0 ? -(int16_t)diviser((uint16_t)-n, r) : (int16_t)diviser((uint16_t)n, r);
+}
+
+/**
+ * @brief Conversion affine d'une plage d'entrée vers une plage de sortie, équivalente à `map()`
+ *
+ * Le résultat est exactement celui de `map(x, entreeMin, entreeMax, sortieMin, sortieMax)`, troncature vers
+ * zéro comprise. Un produit (x - entreeMin) × (sortieMax - sortieMin) de plus de 16 bits passe par une vraie
+ * division, pour rester exact sur toutes les entrées. Une plage d'entrée vide (que `map()` diviserait par
+ * zéro) rend sortieMin.
+ */
+class echelle
+{
+public:
+    constexpr echelle() : echelle(0, 1, 0, 0) {}
+    constexpr echelle(int16_t entreeMin, int16_t entreeMax, int16_t sortieMin, int16_t sortieMax)
+        : m_entreeMin(entreeMin), m_sortieMin(sortieMin),
+          m_pente(entreeMax == entreeMin ? 0 : sortieMax - sortieMin),
+          m_diviseur(entreeMax > entreeMin ? entreeMax - entreeMin : (entreeMax < entreeMin ? entreeMin - entreeMax : 1)),
+          m_negatif(entreeMax < entreeMin),
+          m_reciproque(entreeMax > entreeMin ? entreeMax - entreeMin : (entreeMax < entreeMin ? entreeMin - entreeMax : 1))
+    {
+    }
+
+    inline long operator()(long x) const;
+
+private:
+    int16_t    m_entreeMin;   ///< Début de la plage d'entrée
+    int16_t    m_sortieMin;   ///< Début de la plage de sortie
+    int16_t    m_pente;       ///< sortieMax - sortieMin
+    uint16_t   m_diviseur;    ///< |entreeMax - entreeMin|
+    bool       m_negatif;     ///< entreeMax < entreeMin
+    reciproque m_reciproque;  ///< Inverse de `m_diviseur`
+};
+
+
+
+/**
+ * @brief Convertir une valeur
+ *
+ * @param x [In] Valeur dans la plage d'entrée (ou au-delà, comme avec `map()`)
+ * @return La valeur convertie
+ */
+inline long echelle::operator()(long x) const
+{
+    long produit = (x - m_entreeMin) * m_pente;
+    bool negatif = (produit < 0) != m_negatif;
+    unsigned long absolu = produit < 0 ? -produit : produit;
+
+    unsigned long quotient = absolu > 0xFFFF ? absolu / m_diviseur : diviser(absolu, m_reciproque);
+    return (negatif ? -(long)quotient : (long)quotient) + m_sortieMin;
+}
+
+#endif
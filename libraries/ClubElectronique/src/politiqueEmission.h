@@ -0,0 +1,89 @@
+/**
+ * @file politiqueEmission.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `politiqueEmission` qui décide quand la télécommande doit émettre un message radio.
+ *
+ * Plutôt qu'un message à cadence fixe, la télécommande lit le joystick souvent et n'émet que lorsque la
+ * consigne change : une commande, un bouton, ou un écart d'au moins `seuil` sur la consigne d'un moteur.
+ * Un passage à l'arrêt est toujours émis, même sous le seuil. Sans changement, un battement de cœur est
+ * émis toutes les `battement` ms pour que le bateau ne déclenche pas son failsafe.
+ */
+
+#pragma once
+#ifndef POLITIQUEEMISSION_h
+#define POLITIQUEEMISSION_h
+
+#include "Arduino.h"
+
+#include "radioMessage.h"
+
+class politiqueEmission
+{
+public:
+    inline politiqueEmission(uint8_t seuil, uint16_t battement)
+        : m_seuil(seuil), m_battement(battement), m_gauche(0), m_droit(0), m_boutons(0), m_derniere(0), m_premiere(true) {}
+
+    inline bool aEmettre(radioMessage const & msg, uint8_t boutons, unsigned long maintenant) const;
+    inline void emis(radioMessage const & msg, uint8_t boutons, unsigned long maintenant);
+
+private:
+    inline bool ecart(int8_t consigne, int8_t emise) const;
+
+private:
+    uint8_t       m_seuil;      ///< Écart de consigne moteur qui déclenche une émission (%)
+    uint16_t      m_battement;  ///< Délai maximal entre deux émissions (ms)
+    int8_t        m_gauche;     ///< Consigne du moteur gauche du dernier message émis
+    int8_t        m_droit;      ///< Consigne du moteur droit du dernier message émis
+    uint8_t       m_boutons;    ///< Boutons pressés lors de la dernière émission
+    unsigned long m_derniere;   ///< Instant de la dernière émission (ms)
+    bool          m_premiere;   ///< Aucun message n'a encore été émis
+};
+
+
+
+/**
+ * @brief Décider si le message courant doit être émis
+ *
+ * @param msg        [In] Message prêt à émettre
+ * @param boutons    [In] Masque des boutons pressés
+ * @param maintenant [In] Instant présent (ms)
+ * @return true si la consigne a changé ou si le battement de cœur est dû
+ */
+inline bool politiqueEmission::aEmettre(radioMessage const & msg, uint8_t boutons, unsigned long maintenant) const
+{
+    return m_premiere
+        || msg.cmd != 0
+        || boutons != m_boutons
+        || ecart(msg.gauche, m_gauche)
+        || ecart(msg.droit, m_droit)
+        || maintenant - m_derniere >= m_battement;
+}
+
+/**
+ * @brief Noter le message qui vient d'être émis
+ *
+ * @param msg        [In] Message émis
+ * @param boutons    [In] Masque des boutons pressés
+ * @param maintenant [In] Instant de l'émission (ms)
+ */
+inline void politiqueEmission::emis(radioMessage const & msg, uint8_t boutons, unsigned long maintenant)
+{
+    m_gauche = msg.gauche;
+    m_droit = msg.droit;
+    m_boutons = boutons;
+    m_derniere = maintenant;
+    m_premiere = false;
+}
+
+/**
+ * @brief Une consigne moteur s'est-elle assez éloignée de la dernière consigne émise ?
+ */
+inline bool politiqueEmission::ecart(int8_t consigne, int8_t emise) const
+{
+    if ((consigne == 0) != (emise == 0)) return true;
+    int16_t difference = consigne - emise;
+    return difference >= m_seuil || difference <= -m_seuil;
+}
+
+#endif
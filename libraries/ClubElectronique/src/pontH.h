@@ -0,0 +1,62 @@
+/**
+ * @file pontH.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `pontH` pour contrôler un pont en H et piloter deux moteurs à courant continu.
+ *
+ * Cette classe permet de piloter deux moteurs à courant continu en fonction des valeurs de vitesse fournies 
+ * pour la direction gauche et droite. Elle utilise des broches PWM et de direction pour contràler la vitesse 
+ * et le sens de rotation des moteurs. Tout le pilotage est délégué à `motorBank<2>` : le moteur 0 est le
+ * moteur gauche et le moteur 1 le moteur droit.
+ */
+
+#pragma once
+#ifndef PONTH_h
+#define PONTH_h
+
+#include "common.h"
+#include "motorBank.h"
+
+class pontH : public motorBank<2>
+{
+public:
+    inline pontH(int pwmGauchePin, int directionGauchePin, int pwmDroitePin, int directionDroitePin);
+    inline ~pontH() {}
+
+    using motorBank<2>::vitesseMoteurs;
+    inline void vitesseMoteurs(int8_t const &gauche, int8_t const &droit);
+};
+
+
+
+/**
+ * @brief Constructeur de la classe pontH
+ *
+ * Ce constructeur initialise les broches PWM et de direction pour les deux moteurs.
+ *
+ * @param pwmGauchePin Broche PWM du moteur gauche
+ * @param directionGauchePin Broche de direction du moteur gauche
+ * @param pwmDroitePin Broche PWM du moteur droit
+ * @param directionDroitePin Broche de direction du moteur droit
+ */
+inline pontH::pontH(int pwmGauchePin, int directionGauchePin, int pwmDroitePin, int directionDroitePin)
+    : motorBank<2>({ (uint8_t)pwmGauchePin, (uint8_t)pwmDroitePin }, { (uint8_t)directionGauchePin, (uint8_t)directionDroitePin })
+{
+}
+
+/**
+ * @brief Définir la vitesse des moteurs
+ *
+ * Cette fonction définit la vitesse des deux moteurs en fonction des valeurs de vitesse fournies
+ * pour la direction gauche et droite. Les valeurs de vitesse doivent être comprises entre -100 et 100.
+ * @param gauche [In] Vitesse du moteur gauche (-100 pour la vitesse maximale en arrière, 0 pour à l'arrét, 100 pour la vitesse maximale en avant)
+ * @param droit  [In] Vitesse du moteur droit  (-100 pour la vitesse maximale en arrière, 0 pour à l'arrét, 100 pour la vitesse maximale en avant)
+ */
+inline void pontH::vitesseMoteurs(int8_t const &gauche, int8_t const &droit)
+{
+    int8_t const vitesses[2] = { gauche, droit };
+    motorBank<2>::vitesseMoteurs(vitesses);
+}
+
+
+#endif
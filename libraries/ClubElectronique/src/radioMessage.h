@@ -8,7 +8,10 @@ typedef enum
     PA_LOW = 2,
     PA_HI  = 4,
     PA_MAX = 8,
-    RESET  = 16
+    RESET  = 16,
+    PARAM  = 32,  // gauche et droit portent l'identifiant et la valeur d'un paramètre (parametres.h)
+    PARAM_SAUVER = 64, // Avec PARAM : sauvegarder les paramètres en EEPROM après application
+    SONDE  = 128  // Trame de mesure de la liaison, moteurs arrêtés (sondeRadio.h)
 } radioCmd;
 
 
@@ -17,10 +20,11 @@ typedef struct
     char cmd;
     char gauche;
     char droit;
+    char seq;   // Numéro de séquence, incrémenté à chaque émission
     char check;
 } radioMessage;
 
-inline char computeCheck  (radioMessage const & msg) { return msg.cmd ^ msg.gauche ^ msg.droit; }
+inline char computeCheck  (radioMessage const & msg) { return msg.cmd ^ msg.gauche ^ msg.droit ^ msg.seq; }
 inline void assignCheck   (radioMessage       & msg) { msg.check = computeCheck(msg); }
 inline bool messageIsValid(radioMessage const & msg) { return msg.check == computeCheck(msg); }
 #endif
@@ -13,6 +13,8 @@
 
 #include <avr/wdt.h>
 
+#include "common.h"
+
  /**
   * @brief Redémarrer le système
   *
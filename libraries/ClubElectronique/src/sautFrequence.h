@@ -0,0 +1,281 @@
+/**
+ * @file sautFrequence.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `sautFrequence` : saut de fréquence de la liaison radio du bateau.
+ *
+ * La télécommande émet une trame par créneau de DUREE_CRENEAU_SAUT ms, et le numéro de séquence de la trame
+ * est celui du créneau : la trame `seq` part sur le canal `canal(seq)`. Les NB_CANAUX_SAUT canaux et leur
+ * ordre se déduisent d'une graine commune aux deux radios.
+ *
+ * Le bateau suit les créneaux avec sa propre horloge, recalée à chaque trame reçue : une trame perdue ne
+ * le désynchronise pas. Après CRENEAUX_PERTE_SYNC créneaux sans trame, il se gare sur un canal pendant
+ * NB_CANAUX_SAUT + 1 créneaux, le temps que la télécommande y passe, puis sur le suivant.
+ *
+ * La télécommande compte les trames non acquittées de chaque canal et met en liste noire ceux qui en perdent
+ * trop : leurs créneaux passent sur le canal suivant de la séquence. Chaque changement de la liste est
+ * annoncé au bateau par un message `PARAM` d'identifiant ID_LISTE_NOIRE, et n'est appliqué par la
+ * télécommande qu'une fois acquitté. La liste est rappelée régulièrement (redémarrage du bateau), et un
+ * canal en liste noire est remis à l'essai de temps en temps.
+ */
+
+#pragma once
+#ifndef SAUTFREQUENCE_h
+#define SAUTFREQUENCE_h
+
+#include "Arduino.h"
+
+#include "radioMessage.h"
+
+#define NB_CANAUX_SAUT        16    ///< Canaux de la séquence de saut (diviseur de 256, pour suivre `seq`)
+#define CANAL_SAUT_MIN        2     ///< Premier canal utilisable (2402MHz)
+#define ECART_CANAUX_SAUT     5     ///< Écart entre deux canaux de la séquence (MHz)
+#define DUREE_CRENEAU_SAUT    10    ///< Durée d'un créneau (ms), la période d'émission de la télécommande
+#define CRENEAUX_PERTE_SYNC   50    ///< Créneaux sans trame avant que le bateau se gare sur un canal
+#define ID_LISTE_NOIRE        0xF0  ///< Identifiant des annonces de liste noire, hors du registre des paramètres
+#define LISTE_NOIRE_MAX       6     ///< Canaux en liste noire au plus
+#define FENETRE_CANAL         32    ///< Trames émises sur un canal avant de juger ses pertes
+#define PERTES_LISTE_NOIRE    10    ///< Trames perdues sur FENETRE_CANAL qui mettent un canal en liste noire
+#define RAPPEL_LISTE_NOIRE    128   ///< Trames émises entre deux rappels de la liste noire
+#define ESSAI_LISTE_NOIRE     4096  ///< Trames émises avant de remettre à l'essai un canal en liste noire
+
+class sautFrequence
+{
+public:
+    inline sautFrequence(uint16_t graine, uint16_t dureeCreneau = DUREE_CRENEAU_SAUT);
+
+    inline uint8_t canal(uint8_t seq) const { return m_canaux[position(seq)]; }
+    inline uint16_t listeNoire() const { return m_listeNoire; }
+
+    // Télécommande
+    inline void emise(uint8_t seq, bool acquittee);
+    inline bool preparerAnnonce(radioMessage & msg);
+    inline void annonceAcquittee(radioMessage const & msg) { appliquer(m_listeNoire, msg); }
+
+    // Bateau
+    inline void recue(uint8_t seq, unsigned long maintenant);
+    inline uint8_t canalEcoute(unsigned long maintenant) const;
+    inline bool synchronise(unsigned long maintenant) const;
+    static inline bool estAnnonce(radioMessage const & msg) { return (msg.cmd & radioCmd::PARAM) && (uint8_t)msg.gauche == ID_LISTE_NOIRE; }
+    inline void appliquerAnnonce(radioMessage const & msg) { appliquer(m_listeNoire, msg); m_listeVoulue = m_listeNoire; }
+
+    inline void afficher(Print & sortie) const;
+
+private:
+    inline uint8_t position(uint8_t seq) const;
+    static inline void appliquer(uint16_t & liste, radioMessage const & msg);
+    static inline uint8_t compter(uint16_t liste);
+
+private:
+    uint8_t       m_canaux[NB_CANAUX_SAUT];  ///< Canal de chaque position de la séquence
+    uint16_t      m_dureeCreneau;            ///< Durée d'un créneau (ms)
+    uint16_t      m_listeNoire;              ///< Positions en liste noire, appliquées par les deux radios
+    uint16_t      m_listeVoulue;             ///< Positions que la télécommande veut en liste noire
+    uint8_t       m_emises[NB_CANAUX_SAUT];  ///< Trames émises par position dans la fenêtre en cours
+    uint8_t       m_perdues[NB_CANAUX_SAUT]; ///< Trames non acquittées par position dans la fenêtre en cours
+    uint16_t      m_depuisRappel;            ///< Trames émises depuis le dernier rappel de la liste noire
+    uint16_t      m_depuisEssai;             ///< Trames émises depuis la dernière remise à l'essai
+    uint8_t       m_rappel;                  ///< Prochaine position à rappeler
+    uint8_t       m_seq;                     ///< Numéro de séquence de la dernière trame reçue
+    unsigned long m_instant;                 ///< Instant de réception de la dernière trame (ms)
+    bool          m_synchro;                 ///< Une trame a été reçue depuis le démarrage
+};
+
+
+
+/**
+ * @brief Constructeur : tire les canaux et leur ordre de la graine
+ *
+ * Les canaux sont espacés de ECART_CANAUX_SAUT MHz à partir de CANAL_SAUT_MIN, décalés selon la graine,
+ * puis mélangés (Fisher-Yates avec un générateur congruentiel 16 bits).
+ *
+ * @param graine       [In] Graine commune au bateau et à la télécommande
+ * @param dureeCreneau [In] Durée d'un créneau (ms)
+ */
+inline sautFrequence::sautFrequence(uint16_t graine, uint16_t dureeCreneau)
+    : m_dureeCreneau(dureeCreneau), m_listeNoire(0), m_listeVoulue(0),
+      m_depuisRappel(0), m_depuisEssai(0), m_rappel(0), m_seq(0), m_instant(0), m_synchro(false)
+{
+    uint8_t decalage = graine % ECART_CANAUX_SAUT;
+    for (uint8_t i = 0; i < NB_CANAUX_SAUT; ++i)
+    {
+        m_canaux[i] = CANAL_SAUT_MIN + decalage + i * ECART_CANAUX_SAUT;
+        m_emises[i] = 0;
+        m_perdues[i] = 0;
+    }
+
+    uint16_t alea = graine;
+    for (uint8_t i = NB_CANAUX_SAUT - 1; i > 0; --i)
+    {
+        alea = alea * 25173u + 13849u;
+        uint8_t j = (alea >> 8) % (i + 1);
+        uint8_t canal = m_canaux[i];
+        m_canaux[i] = m_canaux[j];
+        m_canaux[j] = canal;
+    }
+}
+
+/**
+ * @brief Position de la séquence utilisée par le créneau `seq` : la sienne, ou la suivante hors liste noire
+ */
+inline uint8_t sautFrequence::position(uint8_t seq) const
+{
+    uint8_t p = seq % NB_CANAUX_SAUT;
+    for (uint8_t i = 0; i < NB_CANAUX_SAUT; ++i)
+    {
+        if (!(m_listeNoire & (1u << p))) return p;
+        p = (p + 1) % NB_CANAUX_SAUT;
+    }
+    return seq % NB_CANAUX_SAUT;
+}
+
+/**
+ * @brief Compter une trame émise par la télécommande, et juger le canal au bout de FENETRE_CANAL trames
+ *
+ * @param seq       [In] Numéro de séquence (créneau) de la trame
+ * @param acquittee [In] Le bateau a acquitté la trame
+ */
+inline void sautFrequence::emise(uint8_t seq, bool acquittee)
+{
+    uint8_t p = position(seq);
+    ++m_emises[p];
+    if (!acquittee) ++m_perdues[p];
+
+    if (m_emises[p] >= FENETRE_CANAL)
+    {
+        if (m_perdues[p] >= PERTES_LISTE_NOIRE && compter(m_listeVoulue) < LISTE_NOIRE_MAX)
+        {
+            m_listeVoulue |= 1u << p;
+        }
+        m_emises[p] = 0;
+        m_perdues[p] = 0;
+    }
+
+    ++m_depuisRappel;
+    if (++m_depuisEssai >= ESSAI_LISTE_NOIRE)
+    {
+        // Remettre à l'essai le premier canal en liste noire : les brouilleurs ne restent pas toujours
+        m_depuisEssai = 0;
+        for (uint8_t i = 0; i < NB_CANAUX_SAUT; ++i)
+        {
+            if (m_listeVoulue & (1u << i))
+            {
+                m_listeVoulue &= ~(1u << i);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Placer dans le message une annonce de liste noire, s'il y en a une à faire
+ *
+ * Un changement de la liste voulue passe en premier ; sinon, toutes les RAPPEL_LISTE_NOIRE trames, la
+ * position suivante en liste noire est rappelée.
+ *
+ * @param msg [Out] Message à émettre : commande `PARAM`, `gauche` à ID_LISTE_NOIRE, `droit` à la position
+ *                  (bit 4 : en liste noire)
+ * @return true si une annonce a été placée
+ */
+inline bool sautFrequence::preparerAnnonce(radioMessage & msg)
+{
+    uint16_t changements = m_listeVoulue ^ m_listeNoire;
+    uint8_t p = 0;
+    if (changements)
+    {
+        while (!(changements & (1u << p))) ++p;
+    }
+    else if (m_listeNoire && m_depuisRappel >= RAPPEL_LISTE_NOIRE)
+    {
+        p = m_rappel;
+        while (!(m_listeNoire & (1u << p))) p = (p + 1) % NB_CANAUX_SAUT;
+        m_rappel = (p + 1) % NB_CANAUX_SAUT;
+        m_depuisRappel = 0;
+    }
+    else
+    {
+        return false;
+    }
+
+    msg.cmd |= radioCmd::PARAM;
+    msg.gauche = ID_LISTE_NOIRE;
+    msg.droit = p | ((m_listeVoulue & (1u << p)) ? 0x10 : 0);
+    return true;
+}
+
+/**
+ * @brief Appliquer une annonce de liste noire à une liste
+ */
+inline void sautFrequence::appliquer(uint16_t & liste, radioMessage const & msg)
+{
+    uint8_t p = msg.droit & 0x0F;
+    if (msg.droit & 0x10) liste |= 1u << p;
+    else                  liste &= ~(1u << p);
+}
+
+inline uint8_t sautFrequence::compter(uint16_t liste)
+{
+    uint8_t nb = 0;
+    for (; liste; liste &= liste - 1) ++nb;
+    return nb;
+}
+
+/**
+ * @brief Recaler l'horloge des créneaux du bateau sur une trame valide reçue
+ *
+ * @param seq        [In] Numéro de séquence (créneau) de la trame
+ * @param maintenant [In] Instant de réception (ms)
+ */
+inline void sautFrequence::recue(uint8_t seq, unsigned long maintenant)
+{
+    m_seq = seq;
+    m_instant = maintenant;
+    m_synchro = true;
+}
+
+/**
+ * @brief Le bateau suit les créneaux de la télécommande
+ */
+inline bool sautFrequence::synchronise(unsigned long maintenant) const
+{
+    return m_synchro && maintenant - m_instant < (unsigned long)CRENEAUX_PERTE_SYNC * m_dureeCreneau;
+}
+
+/**
+ * @brief Canal sur lequel le bateau doit écouter
+ *
+ * Synchronisé, le bateau passe au canal du créneau suivant une demi-durée de créneau avant la trame
+ * attendue, ce qui absorbe les variations de l'instant d'émission. Sinon, il reste garé
+ * NB_CANAUX_SAUT + 1 créneaux sur chaque canal.
+ *
+ * @param maintenant [In] Instant présent (ms)
+ */
+inline uint8_t sautFrequence::canalEcoute(unsigned long maintenant) const
+{
+    if (!synchronise(maintenant))
+    {
+        return canal(maintenant / ((unsigned long)(NB_CANAUX_SAUT + 1) * m_dureeCreneau));
+    }
+    unsigned long creneaux = (maintenant - m_instant + m_dureeCreneau / 2) / m_dureeCreneau;
+    return canal(m_seq + creneaux);
+}
+
+/**
+ * @brief Afficher la séquence : position, canal, liste noire et pertes de la fenêtre en cours
+ */
+inline void sautFrequence::afficher(Print & sortie) const
+{
+    for (uint8_t p = 0; p < NB_CANAUX_SAUT; ++p)
+    {
+        sortie.print(p);
+        sortie.print('\t');
+        sortie.print(m_canaux[p]);
+        sortie.print((m_listeNoire & (1u << p)) ? F("\tnoire\t") : F("\t-\t"));
+        sortie.print(m_perdues[p]);
+        sortie.print('/');
+        sortie.print(m_emises[p]);
+        sortie.println();
+    }
+}
+
+#endif
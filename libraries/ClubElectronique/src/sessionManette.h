@@ -0,0 +1,104 @@
+/**
+ * @file sessionManette.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit le format binaire des sessions de pilotage enregistrées par la télécommande.
+ *
+ * Chaque échantillon (position du joystick, boutons, temps écoulé) est envoyé sur le port série dans un
+ * paquet de 7 octets : un octet de synchronisation, l'échantillon champ par champ (entiers de poids faible
+ * en premier) et un CRC-8. Le lecteur retrouve les paquets au milieu des autres messages du port série,
+ * ce qui permet de garder les traces de mise au point pendant un enregistrement.
+ */
+
+#pragma once
+#ifndef SESSIONMANETTE_h
+#define SESSIONMANETTE_h
+
+#include "Arduino.h"
+#include "trameCanaux.h"
+
+#define SESSION_SYNCHRO       0xA5 ///< Premier octet de chaque paquet
+#define TAILLE_PAQUET_SESSION 7    ///< Synchro, dt (2 octets), x, y, boutons, CRC-8
+
+/**
+ * @brief Echantillon de la manette
+ */
+typedef struct
+{
+    uint16_t dt;      ///< Temps écoulé depuis l'échantillon précédent (ms)
+    int8_t   x;       ///< Axe X du joystick (-100 à 100)
+    int8_t   y;       ///< Axe Y du joystick (-100 à 100)
+    uint8_t  boutons; ///< Masque des boutons pressés (maskBoutonX)
+} echantillonManette;
+
+/**
+ * @brief Construire le paquet d'un échantillon
+ *
+ * @param paquet [Out] Paquet à envoyer tel quel
+ * @param e      [In]  Echantillon
+ */
+inline void encoderEchantillon(uint8_t (&paquet)[TAILLE_PAQUET_SESSION], echantillonManette const & e)
+{
+    paquet[0] = SESSION_SYNCHRO;
+    paquet[1] = e.dt;
+    paquet[2] = e.dt >> 8;
+    paquet[3] = e.x;
+    paquet[4] = e.y;
+    paquet[5] = e.boutons;
+    paquet[6] = crc8(paquet + 1, TAILLE_PAQUET_SESSION - 2);
+}
+
+/**
+ * @brief Retrouve les échantillons dans un flux d'octets lu sur le port série
+ */
+class lecteurSession
+{
+public:
+    inline lecteurSession() : m_nbOctets(0), m_nbRejets(0) {}
+
+    inline bool ajouter(uint8_t octet, echantillonManette & e);
+    inline unsigned long nbRejets() const { return m_nbRejets; }
+
+private:
+    uint8_t       m_paquet[TAILLE_PAQUET_SESSION]; ///< Paquet en cours de réception
+    uint8_t       m_nbOctets;                      ///< Octets reçus du paquet en cours
+    unsigned long m_nbRejets;                      ///< Paquets rejetés par le CRC
+};
+
+
+
+/**
+ * @brief Ajouter un octet du flux
+ *
+ * En cas de CRC faux, la recherche reprend au prochain octet de synchronisation déjà reçu.
+ *
+ * @param octet [In]  Octet lu
+ * @param e     [Out] Echantillon, rempli seulement quand un paquet complet et valide vient d'arriver
+ * @return true si un échantillon a été décodé
+ */
+inline bool lecteurSession::ajouter(uint8_t octet, echantillonManette & e)
+{
+    if (m_nbOctets == 0 && octet != SESSION_SYNCHRO) return false;
+
+    m_paquet[m_nbOctets++] = octet;
+    if (m_nbOctets < TAILLE_PAQUET_SESSION) return false;
+
+    if (m_paquet[6] == crc8(m_paquet + 1, TAILLE_PAQUET_SESSION - 2))
+    {
+        e.dt = m_paquet[1] | m_paquet[2] << 8;
+        e.x = m_paquet[3];
+        e.y = m_paquet[4];
+        e.boutons = m_paquet[5];
+        m_nbOctets = 0;
+        return true;
+    }
+
+    ++m_nbRejets;
+    uint8_t debut = 1;
+    while (debut < TAILLE_PAQUET_SESSION && m_paquet[debut] != SESSION_SYNCHRO) ++debut;
+    m_nbOctets = TAILLE_PAQUET_SESSION - debut;
+    memmove(m_paquet, m_paquet + debut, m_nbOctets);
+    return false;
+}
+
+#endif
@@ -0,0 +1,281 @@
+/**
+ * @file sondeRadio.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit les trames sondes de la liaison radio, la classe `statistiquesLatence` et le bilan des rafales.
+ *
+ * Les trames de mesure de la liaison portent la commande `SONDE` ; les autres bits de la commande en donnent
+ * le type (`typeSonde`) et n'ont pas leur sens habituel. Le bateau arrête ses moteurs à chaque trame sonde.
+ * - Écho : `gauche` et `droit` portent les 16 bits de poids faible de `micros()` à l'émission. Le bateau
+ *   renvoie la trame telle quelle par son canal d'émission : la télécommande en déduit le temps
+ *   d'aller-retour sans rien mémoriser.
+ * - Réglage : le bateau passe à une puissance (`gauche`, RF24_PA_MIN à RF24_PA_MAX) et un débit (`droit`,
+ *   rf24_datarate_e), et remet ses compteurs de rafale à zéro. Sans trame valide pendant
+ *   DELAI_REGLAGE_SONDE ms, il revient à ses réglages de démarrage.
+ * - Rafale : le bateau la compte, sans répondre.
+ * - Bilan : le bateau répond par une trame bilan qui porte ses compteurs de rafale.
+ */
+
+#pragma once
+#ifndef SONDERADIO_h
+#define SONDERADIO_h
+
+#include "Arduino.h"
+
+#include "radioMessage.h"
+
+#define FENETRE_SONDE_MAX   100  ///< Nombre maximal de sondes d'une mesure
+#define DELAI_REGLAGE_SONDE 500  ///< Délai sans trame valide avant le retour aux réglages de démarrage (ms)
+#define DEBIT_DEMARRAGE     0    ///< Débit de la radio au démarrage (RF24_1MBPS)
+#define NB_DEBITS           3    ///< Débits de la radio (RF24_1MBPS, RF24_2MBPS, RF24_250KBPS)
+#define NB_PUISSANCES       4    ///< Puissances de la radio (RF24_PA_MIN à RF24_PA_MAX)
+
+/**
+ * @brief Types de trames sondes, dans les bits de la commande autres que `SONDE`
+ */
+typedef enum : uint8_t
+{
+    SONDE_ECHO    = 0,                ///< Renvoyée telle quelle par le bateau
+    SONDE_RAFALE  = 1,                ///< Comptée par le bateau, sans réponse
+    SONDE_BILAN   = 2,                ///< Le bateau répond par ses compteurs de rafale
+    SONDE_REGLAGE = radioCmd::PARAM,  ///< Changement de puissance et de débit du bateau
+} typeSonde;
+
+/**
+ * @brief Type d'une trame sonde
+ */
+inline uint8_t typeTrameSonde(radioMessage const & msg) { return msg.cmd & ~radioCmd::SONDE; }
+
+/**
+ * @brief Préparer une trame sonde horodatée
+ *
+ * @param msg        [Out] Message à émettre (le numéro de séquence est conservé)
+ * @param maintenant [In]  Instant d'émission (µs)
+ */
+inline void preparerSonde(radioMessage & msg, uint16_t maintenant)
+{
+    msg.cmd = radioCmd::SONDE;
+    msg.gauche = maintenant & 0xFF;
+    msg.droit = maintenant >> 8;
+}
+
+/**
+ * @brief Préparer une trame de changement des réglages radio
+ *
+ * @param msg       [Out] Message à émettre (le numéro de séquence est conservé)
+ * @param puissance [In]  Puissance (RF24_PA_MIN à RF24_PA_MAX)
+ * @param debit     [In]  Débit (rf24_datarate_e)
+ */
+inline void preparerReglage(radioMessage & msg, uint8_t puissance, uint8_t debit)
+{
+    msg.cmd = radioCmd::SONDE | SONDE_REGLAGE;
+    msg.gauche = puissance;
+    msg.droit = debit;
+}
+
+/**
+ * @brief Préparer une trame de rafale ou une demande de bilan
+ *
+ * @param msg  [Out] Message à émettre (le numéro de séquence est conservé)
+ * @param type [In]  SONDE_RAFALE ou SONDE_BILAN
+ */
+inline void preparerRafale(radioMessage & msg, typeSonde type)
+{
+    msg.cmd = radioCmd::SONDE | type;
+    msg.gauche = 0;
+    msg.droit = 0;
+}
+
+inline bool estSonde(radioMessage const & msg)   { return (msg.cmd & radioCmd::SONDE) && typeTrameSonde(msg) == SONDE_ECHO; }
+inline bool estReglage(radioMessage const & msg) { return (msg.cmd & radioCmd::SONDE) && typeTrameSonde(msg) == SONDE_REGLAGE; }
+inline bool estRafale(radioMessage const & msg)  { return (msg.cmd & radioCmd::SONDE) && typeTrameSonde(msg) == SONDE_RAFALE; }
+inline bool estBilan(radioMessage const & msg)   { return (msg.cmd & radioCmd::SONDE) && typeTrameSonde(msg) == SONDE_BILAN; }
+
+/**
+ * @brief Instant d'émission d'une trame sonde (µs, 16 bits de poids faible)
+ */
+inline uint16_t horodatageSonde(radioMessage const & msg) { return (uint8_t)msg.gauche | (uint16_t)(uint8_t)msg.droit << 8; }
+
+/**
+ * @brief Afficher le nom d'une puissance ou d'un débit de la radio
+ */
+inline void afficherPuissance(Print & sortie, uint8_t puissance)
+{
+    static char const * const NOMS[NB_PUISSANCES] = { "MIN", "LOW", "HIGH", "MAX" };
+    sortie.print(puissance < NB_PUISSANCES ? NOMS[puissance] : "?");
+}
+
+inline void afficherDebit(Print & sortie, uint8_t debit)
+{
+    static char const * const NOMS[NB_DEBITS] = { "1M", "2M", "250k" };
+    sortie.print(debit < NB_DEBITS ? NOMS[debit] : "?");
+}
+
+/**
+ * @brief Temps d'aller-retour et pertes d'une série de sondes
+ */
+class statistiquesLatence
+{
+public:
+    inline statistiquesLatence() : m_nb(0), m_perdues(0), m_trie(true) {}
+
+    inline void ajouter(uint16_t allerRetour);
+    inline void perdue() { ++m_perdues; }
+
+    inline uint8_t recues() const { return m_nb; }
+    inline uint8_t perdues() const { return m_perdues; }
+    inline uint16_t centile(uint8_t pourcent);
+    inline uint16_t minimum() { return centile(0); }
+    inline uint16_t mediane() { return centile(50); }
+
+    inline void afficher(Print & sortie);
+
+private:
+    inline void trier();
+
+private:
+    uint16_t m_mesures[FENETRE_SONDE_MAX]; ///< Temps d'aller-retour des sondes revenues (µs)
+    uint8_t  m_nb;                         ///< Nombre de sondes revenues
+    uint8_t  m_perdues;                    ///< Nombre de sondes perdues, à l'aller ou au retour
+    bool     m_trie;                       ///< Les mesures sont triées
+};
+
+
+
+/**
+ * @brief Ajouter le temps d'aller-retour d'une sonde revenue (ignoré au-delà de FENETRE_SONDE_MAX)
+ *
+ * @param allerRetour [In] Temps d'aller-retour (µs)
+ */
+inline void statistiquesLatence::ajouter(uint16_t allerRetour)
+{
+    if (m_nb >= FENETRE_SONDE_MAX) return;
+    m_mesures[m_nb++] = allerRetour;
+    m_trie = false;
+}
+
+/**
+ * @brief Centile des temps d'aller-retour, au rang le plus proche
+ *
+ * @param pourcent [In] Centile voulu (0 pour le minimum, 100 pour le maximum)
+ * @return Temps d'aller-retour (µs), 0 si aucune sonde n'est revenue
+ */
+inline uint16_t statistiquesLatence::centile(uint8_t pourcent)
+{
+    if (!m_nb) return 0;
+    trier();
+    uint16_t rang = ((uint16_t)pourcent * m_nb + 99) / 100;
+    return m_mesures[rang ? rang - 1 : 0];
+}
+
+/**
+ * @brief Afficher sondes émises, pertes (%), minimum, médiane et 99e centile (µs), séparés par des tabulations
+ */
+inline void statistiquesLatence::afficher(Print & sortie)
+{
+    uint16_t emises = m_nb + m_perdues;
+    sortie.print(emises);
+    sortie.print('\t');
+    sortie.print(emises ? 100.0 * m_perdues / emises : 0.0, 1);
+    sortie.print('\t');
+    sortie.print(minimum());
+    sortie.print('\t');
+    sortie.print(mediane());
+    sortie.print('\t');
+    sortie.print(centile(99));
+    sortie.println();
+}
+
+/**
+ * @brief Trier les mesures par insertion (une centaine au plus, une seule fois par série)
+ */
+inline void statistiquesLatence::trier()
+{
+    if (m_trie) return;
+    for (uint8_t i = 1; i < m_nb; ++i)
+    {
+        uint16_t mesure = m_mesures[i];
+        uint8_t j = i;
+        for (; j > 0 && m_mesures[j - 1] > mesure; --j)
+        {
+            m_mesures[j] = m_mesures[j - 1];
+        }
+        m_mesures[j] = mesure;
+    }
+    m_trie = true;
+}
+
+/**
+ * @brief Compteurs de rafale du bateau, renvoyés dans une trame bilan
+ */
+class compteurRafale
+{
+public:
+    inline compteurRafale() { remettreAZero(); }
+
+    inline void recue() { if (m_recues < 0xFFFF) ++m_recues; }
+    inline void invalide() { if (m_invalides < 0xFF) ++m_invalides; }
+    inline void remettreAZero() { m_recues = 0; m_invalides = 0; }
+
+    inline void preparerBilan(radioMessage & msg) const;
+    static inline void lireBilan(radioMessage const & msg, uint16_t & recues, uint8_t & invalides);
+
+private:
+    uint16_t m_recues;    ///< Trames de rafale valides reçues
+    uint8_t  m_invalides; ///< Trames reçues à la somme de contrôle fausse
+};
+
+/**
+ * @brief Résultat d'une rafale à un réglage de la radio, vu de la télécommande
+ */
+struct mesureRafale
+{
+    uint16_t      emises;       ///< Trames de rafale émises
+    uint16_t      acquittees;   ///< Trames acquittées par le bateau
+    unsigned long reemissions;  ///< Somme des réémissions de chaque trame
+    unsigned long duree;        ///< Durée de la rafale (µs)
+    uint16_t      recues;       ///< Trames valides reçues par le bateau (bilan)
+    uint8_t       invalides;    ///< Trames à la somme de contrôle fausse reçues par le bateau (bilan)
+
+    inline void afficher(Print & sortie) const;
+};
+
+
+
+/**
+ * @brief Préparer la trame bilan : `gauche` et `droit` portent les trames reçues, `seq` les invalides
+ */
+inline void compteurRafale::preparerBilan(radioMessage & msg) const
+{
+    msg.cmd = radioCmd::SONDE | SONDE_BILAN;
+    msg.gauche = m_recues & 0xFF;
+    msg.droit = m_recues >> 8;
+    msg.seq = m_invalides;
+    assignCheck(msg);
+}
+
+/**
+ * @brief Lire les compteurs d'une trame bilan
+ */
+inline void compteurRafale::lireBilan(radioMessage const & msg, uint16_t & recues, uint8_t & invalides)
+{
+    recues = (uint8_t)msg.gauche | (uint16_t)(uint8_t)msg.droit << 8;
+    invalides = msg.seq;
+}
+
+/**
+ * @brief Afficher trames/s, pertes (%), réémissions moyennes par trame et trames invalides, séparés par des tabulations
+ */
+inline void mesureRafale::afficher(Print & sortie) const
+{
+    sortie.print(duree ? 1000000.0 * emises / duree : 0.0, 0);
+    sortie.print('\t');
+    sortie.print(emises && recues <= emises ? 100.0 * (emises - recues) / emises : 0.0, 1);
+    sortie.print('\t');
+    sortie.print(emises ? (double)reemissions / emises : 0.0, 2);
+    sortie.print('\t');
+    sortie.print(invalides);
+    sortie.println();
+}
+
+#endif
@@ -0,0 +1,148 @@
+/**
+ * @file trameCanaux.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la trame radio proportionnelle multi-canaux de l'avion RC.
+ *
+ * La trame transporte NB_CANAUX canaux de BITS_CANAL bits empaquetés les uns à la suite des autres
+ * (bit de poids faible en premier), suivis d'un numéro de séquence et d'un CRC-8.
+ * Avec 8 canaux de 11 bits, la trame fait 13 octets.
+ */
+
+#pragma once
+#ifndef TRAMECANAUX_h
+#define TRAMECANAUX_h
+
+#include "Arduino.h"
+
+#define NB_CANAUX     8                           ///< Nombre de canaux transportés
+#define BITS_CANAL    11                          ///< Résolution d'un canal en bits
+#define CANAL_MIN     0                           ///< Valeur minimale d'un canal
+#define CANAL_MAX     ((1 << BITS_CANAL) - 1)     ///< Valeur maximale d'un canal
+#define CANAL_CENTRE  (1 << (BITS_CANAL - 1))     ///< Valeur d'un canal au neutre
+
+#define OCTETS_CANAUX ((NB_CANAUX * BITS_CANAL + 7) / 8) ///< Taille des canaux empaquetés
+
+/**
+ * @brief Affectation des canaux
+ */
+typedef enum
+{
+    CANAL_PROFONDEUR = 0, ///< Gouverne de profondeur (tangage)
+    CANAL_DIRECTION,      ///< Gouverne de direction (lacet)
+    CANAL_GAZ,            ///< Moteur
+    CANAL_AILERONS,       ///< Ailerons (roulis)
+    CANAL_AUX1,
+    CANAL_AUX2,
+    CANAL_AUX3,
+    CANAL_AUX4
+} canal;
+
+/**
+ * @brief Trame radio telle qu'envoyée sur la liaison
+ */
+typedef struct
+{
+    uint8_t canaux[OCTETS_CANAUX]; ///< Canaux empaquetés
+    uint8_t seq;                   ///< Numéro de séquence, incrémenté à chaque trame
+    uint8_t crc;                   ///< CRC-8 (polynôme 0x07) de tous les octets précédents
+} trameCanaux;
+
+/**
+ * @brief Calculer le CRC-8 (polynôme 0x07, valeur initiale 0) d'un bloc d'octets
+ *
+ * @param donnees [In] Octets à protéger
+ * @param taille  [In] Nombre d'octets
+ * @return Le CRC-8 des octets
+ */
+inline uint8_t crc8(uint8_t const * donnees, uint8_t taille)
+{
+    uint8_t crc = 0;
+    while (taille--)
+    {
+        crc ^= *donnees++;
+        for (uint8_t i = 0; i < 8; ++i)
+        {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Construire une trame à partir des valeurs des canaux
+ *
+ * @param trame  [Out] Trame à remplir
+ * @param canaux [In]  Valeur de chaque canal, ramenée entre CANAL_MIN et CANAL_MAX
+ * @param seq    [In]  Numéro de séquence de la trame
+ */
+inline void encoderTrame(trameCanaux & trame, uint16_t const (&canaux)[NB_CANAUX], uint8_t seq)
+{
+    uint32_t accumulateur = 0;
+    uint8_t  nbBits = 0;
+    uint8_t  octet = 0;
+
+    for (uint8_t i = 0; i < NB_CANAUX; ++i)
+    {
+        uint16_t valeur = canaux[i] > CANAL_MAX ? CANAL_MAX : canaux[i];
+        accumulateur |= (uint32_t)valeur << nbBits;
+        nbBits += BITS_CANAL;
+
+        while (nbBits >= 8)
+        {
+            trame.canaux[octet++] = accumulateur;
+            accumulateur >>= 8;
+            nbBits -= 8;
+        }
+    }
+    if (nbBits) trame.canaux[octet] = accumulateur;
+
+    trame.seq = seq;
+    trame.crc = crc8(reinterpret_cast<uint8_t const *>(&trame), sizeof(trame) - 1);
+}
+
+/**
+ * @brief Vérifier une trame et en extraire les canaux
+ *
+ * @param trame  [In]  Trame reçue
+ * @param canaux [Out] Valeur de chaque canal, modifiée seulement si la trame est valide
+ * @return true si le CRC de la trame est correct
+ */
+inline bool decoderTrame(trameCanaux const & trame, uint16_t (&canaux)[NB_CANAUX])
+{
+    if (trame.crc != crc8(reinterpret_cast<uint8_t const *>(&trame), sizeof(trame) - 1))
+    {
+        return false;
+    }
+
+    uint32_t accumulateur = 0;
+    uint8_t  nbBits = 0;
+    uint8_t  octet = 0;
+
+    for (uint8_t i = 0; i < NB_CANAUX; ++i)
+    {
+        while (nbBits < BITS_CANAL)
+        {
+            accumulateur |= (uint32_t)trame.canaux[octet++] << nbBits;
+            nbBits += 8;
+        }
+        canaux[i] = accumulateur & CANAL_MAX;
+        accumulateur >>= BITS_CANAL;
+        nbBits -= BITS_CANAL;
+    }
+    return true;
+}
+
+/**
+ * @brief Convertir une position de manche en pourcentage (-100 à 100) en valeur de canal
+ *
+ * @param pourcentage [In] Position du manche
+ * @return Valeur du canal, CANAL_CENTRE au neutre
+ */
+inline uint16_t pourcentageVersCanal(int8_t pourcentage)
+{
+    pourcentage = constrain(pourcentage, -100, 100);
+    return CANAL_CENTRE + (int16_t)pourcentage * (CANAL_MAX - CANAL_CENTRE) / 100;
+}
+
+#endif
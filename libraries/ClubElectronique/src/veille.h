@@ -0,0 +1,120 @@
+/**
+ * @file veille.h
+ * @author Florent LERAY, Jérémy Lefort Besnard
+ * @date 2024-03-06
+ * @brief Définit la classe `veille` pour endormir le microcontrôleur entre deux traitements.
+ *
+ * Le microcontrôleur est placé en mode IDLE : le timer 0 continue de tourner, `millis()` reste juste et
+ * son interruption réveille le processeur chaque milliseconde. La classe mesure aussi le temps passé
+ * endormi pour estimer le rapport cyclique et l'autonomie de la batterie.
+ */
+
+#pragma once
+#ifndef VEILLE_h
+#define VEILLE_h
+
+#include <avr/sleep.h>
+
+#include "common.h"
+
+// **Consommations utilisées pour estimer l'autonomie (à ajuster selon le montage)**
+#ifndef CONSO_ACTIF_MA
+#define CONSO_ACTIF_MA 30           ///< Consommation microcontrôleur et radio actifs (mA)
+#endif
+#ifndef CONSO_VEILLE_MA
+#define CONSO_VEILLE_MA 8           ///< Consommation en veille, radio éteinte (mA)
+#endif
+#ifndef CAPACITE_BATTERIE_MAH
+#define CAPACITE_BATTERIE_MAH 2000  ///< Capacité de la batterie (mAh)
+#endif
+
+class veille
+{
+public:
+    inline veille() { demarrerMesure(); }
+
+    inline void sieste();
+    inline void dormirJusqua(unsigned long echeance);
+
+    inline void demarrerMesure();
+    inline uint8_t rapportCyclique() const;
+    inline void rapport() const;
+
+private:
+    unsigned long m_debutMesure;    ///< Début de la fenêtre de mesure (µs)
+    unsigned long m_tempsSommeil;   ///< Temps passé endormi depuis le début de la fenêtre (µs)
+};
+
+
+
+/**
+ * @brief Dormir jusqu'à la prochaine interruption
+ *
+ * Le processeur est réveillé au plus tard par l'interruption du timer 0 (environ 1ms).
+ */
+inline void veille::sieste()
+{
+    unsigned long debut = micros();
+
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+
+    m_tempsSommeil += micros() - debut;
+}
+
+/**
+ * @brief Dormir jusqu'à une échéance
+ *
+ * @param echeance [In] Instant du réveil, exprimé comme `millis()`
+ */
+inline void veille::dormirJusqua(unsigned long echeance)
+{
+    while ((long)(echeance - millis()) > 0)
+    {
+        sieste();
+    }
+}
+
+/**
+ * @brief Commencer une nouvelle fenêtre de mesure du rapport cyclique
+ */
+inline void veille::demarrerMesure()
+{
+    m_debutMesure = micros();
+    m_tempsSommeil = 0;
+}
+
+/**
+ * @brief Rapport cyclique depuis le début de la fenêtre de mesure
+ *
+ * @return Pourcentage du temps passé éveillé (0 à 100)
+ */
+inline uint8_t veille::rapportCyclique() const
+{
+    unsigned long centieme = (micros() - m_debutMesure) / 100;
+    if (centieme == 0) return 100;
+
+    unsigned long endormi = m_tempsSommeil / centieme;
+    return endormi > 100 ? 0 : 100 - endormi;
+}
+
+/**
+ * @brief Afficher le rapport cyclique et l'autonomie estimée sur le port série
+ */
+inline void veille::rapport() const
+{
+    uint8_t actif = rapportCyclique();
+    uint32_t consoMoyenne = ((uint32_t)CONSO_ACTIF_MA * actif + (uint32_t)CONSO_VEILLE_MA * (100 - actif)); // en centièmes de mA
+
+    Serial.print(F("Actif "));
+    Serial.print(actif);
+    Serial.print(F("% conso "));
+    Serial.print(consoMoyenne / 100);
+    Serial.print(F(" mA autonomie "));
+    Serial.print((uint32_t)CAPACITE_BATTERIE_MAH * 100 / consoMoyenne);
+    Serial.println(F(" h"));
+}
+
+#endif